@@ -210,6 +210,50 @@ defsha3(512)
 
 }
 
+namespace
+{
+size_t const c_sha3Rate = 200 - 256 / 4;
+}
+
+void SHA3Stream::reset()
+{
+	memset(m_state, 0, sizeof(m_state));
+	m_pos = 0;
+}
+
+void SHA3Stream::update(bytesConstRef _input)
+{
+	uint8_t* a = (uint8_t*)m_state;
+	uint8_t const* in = _input.data();
+	size_t len = _input.size();
+	while (len > 0)
+	{
+		size_t const part = min(len, c_sha3Rate - m_pos);
+		keccak::xorin(a + m_pos, in, part);
+		m_pos += part;
+		in += part;
+		len -= part;
+		if (m_pos == c_sha3Rate)
+		{
+			keccak::keccakf(a);
+			m_pos = 0;
+		}
+	}
+}
+
+h256 SHA3Stream::final()
+{
+	// Same padding as keccak::hash
+	uint8_t* a = (uint8_t*)m_state;
+	a[m_pos] ^= 0x01;
+	a[c_sha3Rate - 1] ^= 0x80;
+	keccak::keccakf(a);
+	h256 ret;
+	memcpy(ret.data(), a, h256::size);
+	reset();
+	return ret;
+}
+
 bool sha3(bytesConstRef _input, bytesRef o_output)
 {
 	// FIXME: What with unaligned memory?
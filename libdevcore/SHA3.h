@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include "FixedHash.h"
 #include "vector_ref.h"
@@ -61,6 +62,23 @@ template<unsigned N> inline SecureFixedHash<32> sha3Secure(SecureFixedHash<N> co
 /// Calculate SHA3-256 hash of the given input, possibly interpreting it as nibbles, and return the hash as a string filled with binary data.
 inline std::string sha3(std::string const& _input, bool _isNibbles) { return asString((_isNibbles ? sha3(fromHex(_input)) : sha3(bytesConstRef(&_input))).asBytes()); }
 
+/// SHA3-256 of the data passed in parts, without keeping the data in memory.
+/// final() returns the same hash as sha3() of all parts concatenated.
+class SHA3Stream
+{
+public:
+	SHA3Stream() { reset(); }
+	void update(bytesConstRef _input);
+	void update(char const* _data, size_t _size) { update(bytesConstRef((byte const*)_data, _size)); }
+	/// @returns the hash of the data passed so far and starts a new hash.
+	h256 final();
+	void reset();
+
+private:
+	uint64_t m_state[25];
+	size_t m_pos;  ///< bytes absorbed in the current block
+};
+
 /// Calculate SHA3-256 MAC
 inline void sha3mac(bytesConstRef _secret, bytesConstRef _plain, bytesRef _output) { sha3(_secret.toBytes() + _plain.toBytes()).ref().populate(_output); }
 
@@ -0,0 +1,146 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file TrieHash.cpp
+ */
+
+#include "TrieHash.h"
+#include "RLP.h"
+#include "SHA3.h"
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+h256 const EmptyTrie = sha3(rlp(""));
+}
+
+namespace
+{
+// Records with keys converted into nibbles, sorted by key
+using NibbleRecords = std::vector<std::pair<bytes, bytes>>;
+using NibbleRecordsIt = NibbleRecords::const_iterator;
+
+/// Compact encoding of the nibble path [_begin, _end) with the leaf/extension flag
+bytes hexPrefixEncode(bytes const& _hexVector, bool _leaf, size_t _begin, size_t _end)
+{
+	bool odd = ((_end - _begin) % 2) != 0;
+	bytes ret(1, ((_leaf ? 2 : 0) | (odd ? 1 : 0)) * 16);
+	ret.reserve(1 + (_end - _begin) / 2);
+	if (odd)
+	{
+		ret[0] |= _hexVector[_begin];
+		++_begin;
+	}
+	for (size_t i = _begin; i < _end; i += 2)
+		ret.push_back(_hexVector[i] * 16 + _hexVector[i + 1]);
+	return ret;
+}
+
+void hash256rlp(NibbleRecordsIt _begin, NibbleRecordsIt _end, size_t _preLen, RLPStream& _rlp);
+
+/// Append the node to its parent. Nodes shorter than 32 bytes are inlined, others are referenced by hash
+void hash256aux(NibbleRecordsIt _begin, NibbleRecordsIt _end, size_t _preLen, RLPStream& _rlp)
+{
+	RLPStream rlp;
+	hash256rlp(_begin, _end, _preLen, rlp);
+	if (rlp.out().size() < 32)
+		_rlp.appendRaw(rlp.out());
+	else
+		_rlp << sha3(rlp.out());
+}
+
+void hash256rlp(NibbleRecordsIt _begin, NibbleRecordsIt _end, size_t _preLen, RLPStream& _rlp)
+{
+	if (_begin == _end)
+		_rlp << "";  // NULL
+	else if (std::next(_begin) == _end)
+	{
+		// only one left - terminate with the pair.
+		_rlp.appendList(2) << hexPrefixEncode(_begin->first, true, _preLen, _begin->first.size()) << _begin->second;
+	}
+	else
+	{
+		// find the number of common prefix nibbles shared
+		// records are sorted, so the first and the last records have the shortest common prefix
+		bytes const& first = _begin->first;
+		bytes const& last = std::prev(_end)->first;
+		size_t const maxShared = std::min(first.size(), last.size());
+		size_t sharedPre = _preLen;
+		while (sharedPre < maxShared && first[sharedPre] == last[sharedPre])
+			++sharedPre;
+
+		if (sharedPre > _preLen)
+		{
+			// if they all have the same next nibble, we also want a pair.
+			_rlp.appendList(2) << hexPrefixEncode(first, false, _preLen, sharedPre);
+			hash256aux(_begin, _end, sharedPre, _rlp);
+		}
+		else
+		{
+			// otherwise enumerate all 16+1 entries.
+			_rlp.appendList(17);
+			auto b = _begin;
+			if (_preLen == b->first.size())
+				++b;
+			for (dev::byte i = 0; i < 16; ++i)
+			{
+				auto n = b;
+				for (; n != _end && n->first[_preLen] == i; ++n) {}
+				if (b == n)
+					_rlp << "";
+				else
+					hash256aux(b, n, _preLen + 1, _rlp);
+				b = n;
+			}
+			if (_preLen == _begin->first.size())
+				_rlp << _begin->second;
+			else
+				_rlp << "";
+		}
+	}
+}
+}  // namespace
+
+namespace dev
+{
+h256 hash256(BytesMap const& _s)
+{
+	if (_s.empty())
+		return EmptyTrie;
+
+	// BytesMap is sorted by key, nibble keys keep the same order
+	NibbleRecords records;
+	records.reserve(_s.size());
+	for (auto const& record : _s)
+		records.emplace_back(asNibbles(bytesConstRef(&record.first)), record.second);
+
+	RLPStream s;
+	hash256rlp(records.cbegin(), records.cend(), 0, s);
+	return sha3(s.out());
+}
+
+h256 orderedTrieRoot(std::vector<bytes> const& _data)
+{
+	BytesMap m;
+	unsigned j = 0;
+	for (auto const& b : _data)
+		m.emplace(rlp(j++), b);
+	return hash256(m);
+}
+
+}
@@ -0,0 +1,39 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file TrieHash.h
+ * Merkle Patricia trie root calculation without building the trie database.
+ */
+
+#pragma once
+
+#include "Common.h"
+#include "FixedHash.h"
+
+namespace dev
+{
+
+/// Root hash of the trie made of the key -> value records from _s
+h256 hash256(BytesMap const& _s);
+
+/// Root hash of the trie where keys are rlp(index) of the _data elements.
+/// (transactionsTrie, receiptTrie)
+h256 orderedTrieRoot(std::vector<bytes> const& _data);
+
+/// Root of the empty trie: sha3(rlp(""))
+extern h256 const EmptyTrie;
+
+}
@@ -0,0 +1,274 @@
+#include "ExecTimeStats.h"
+#include <libdevcore/CommonIO.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+using namespace test;
+namespace fs = boost::filesystem;
+
+namespace
+{
+std::mutex g_execTimeStatsMutex;
+ExecTimeRecords g_records;
+bool g_recordsLoaded = false;
+
+// Actual time of the files and tests executed in the current folder
+struct RecordTime
+{
+    string key;
+    double actual;
+};
+std::vector<RecordTime> g_folderTimes;
+std::vector<RecordTime> g_folderTestTimes;
+
+fs::path statsFile()
+{
+    return Options::getRetestethDataDir() / "exectime.stats";
+}
+
+string statsKey(fs::path const& _file)
+{
+    string const mode = Options::get().filltests ? "fill" : "run";
+    fs::path const relative = fs::relative(_file, test::getTestPath());
+    return Options::getCurrentConfig().cfgFile().name() + " " + mode + " " + relative.string();
+}
+
+// Time of a run filtered by network or transaction is not the time of the test
+bool filteredRun()
+{
+    Options const& opt = Options::get();
+    return !opt.singleTestNet.empty() || !opt.getGStateTransactionFilter().empty();
+}
+
+void loadStats()
+{
+    if (g_recordsLoaded)
+        return;
+    g_recordsLoaded = true;
+    fs::path const file = statsFile();
+    if (!fs::exists(file))
+        return;
+    std::vector<string> malformed;
+    g_records.parse(dev::contentsString(file), malformed);
+    for (auto const& line : malformed)
+        ETH_WARNING("Skipping malformed record in " + file.string() + ": " + line);
+}
+
+void saveStats()
+{
+    fs::path const file = statsFile();
+    if (!fs::exists(file.parent_path()))
+        return;
+    fs::path const tmpFile = file.string() + ".tmp";
+    {
+        std::ofstream out(tmpFile.string(), std::ios::trunc);
+        if (!out.is_open())
+        {
+            ETH_WARNING("Could not open " + tmpFile.string() + " to store the execution time stats");
+            return;
+        }
+        out << g_records.serialize();
+        out.close();
+        if (out.fail())
+        {
+            ETH_WARNING("Could not write the execution time stats to " + tmpFile.string());
+            return;
+        }
+    }
+    boost::system::error_code ec;
+    fs::rename(tmpFile, file, ec);
+    if (ec)
+        ETH_WARNING("Could not replace " + file.string() + " with the new execution time stats: " + ec.message());
+}
+
+// Print the records of this folder with the most time and their expected time
+void printSlowest(std::vector<RecordTime> const& _times, size_t _count)
+{
+    std::vector<RecordTime> slowest = _times;
+    std::sort(slowest.begin(), slowest.end(), [](RecordTime const& _a, RecordTime const& _b) { return _a.actual > _b.actual; });
+    for (size_t i = 0; i < slowest.size() && i < _count; i++)
+    {
+        double expected = 0;
+        string const expectedStr = g_records.expected(slowest.at(i).key, expected) ? fto_string(expected) : "-";
+        std::cout << std::left << setw(45) << slowest.at(i).key << " : " << expectedStr << " vs " << slowest.at(i).actual
+                  << std::endl;
+    }
+}
+}  // namespace
+
+namespace test
+{
+void ExecTimeRecords::parse(string const& _content, std::vector<string>& _malformed)
+{
+    for (auto const& line : test::explode(_content, '\n'))
+    {
+        size_t const pos = line.find(' ');
+        if (pos == string::npos)
+            continue;
+        try
+        {
+            // Parse before the map access, operator[] would insert the key of a malformed line
+            double const seconds = std::stod(line.substr(0, pos));
+            m_expected[line.substr(pos + 1)] = seconds;
+        }
+        catch (std::exception const&)
+        {
+            _malformed.push_back(line);
+        }
+    }
+}
+
+string ExecTimeRecords::serialize() const
+{
+    std::ostringstream out;
+    out << std::setprecision(6);
+    for (auto const& el : m_expected)
+        out << el.second << " " << el.first << "\n";
+    return out.str();
+}
+
+void ExecTimeRecords::update(string const& _key, double _seconds)
+{
+    auto const it = m_expected.find(_key);
+    if (it == m_expected.end())
+        m_expected[_key] = _seconds;
+    else
+        it->second = (it->second + _seconds) / 2;
+}
+
+bool ExecTimeRecords::expected(string const& _key, double& _seconds) const
+{
+    auto const it = m_expected.find(_key);
+    if (it == m_expected.end())
+        return false;
+    _seconds = it->second;
+    return true;
+}
+
+bool ExecTimeRecords::expectedFileTime(string const& _fileKey, double& _seconds) const
+{
+    if (expected(_fileKey, _seconds))
+        return true;
+
+    // Test records of the file follow each other in the map
+    string const prefix = testKey(_fileKey, string());
+    bool found = false;
+    _seconds = 0;
+    for (auto it = m_expected.lower_bound(prefix); it != m_expected.end(); it++)
+    {
+        if (it->first.compare(0, prefix.size(), prefix) != 0)
+            break;
+        _seconds += it->second;
+        found = true;
+    }
+    return found;
+}
+
+std::vector<size_t> ExecTimeRecords::longestFirst(std::vector<string> const& _fileKeys) const
+{
+    std::vector<std::pair<double, size_t>> timed;
+    for (size_t i = 0; i < _fileKeys.size(); i++)
+    {
+        double expected = 0;
+        if (!expectedFileTime(_fileKeys.at(i), expected))
+            expected = std::numeric_limits<double>::max();
+        timed.push_back({expected, i});
+    }
+
+    // Stable sort keeps the directory order for files with equal time
+    std::stable_sort(timed.begin(), timed.end(),
+        [](std::pair<double, size_t> const& _a, std::pair<double, size_t> const& _b) { return _a.first > _b.first; });
+    std::vector<size_t> order;
+    for (auto const& el : timed)
+        order.push_back(el.second);
+    return order;
+}
+
+void ExecTimeStats::sortLongestFirst(std::vector<fs::path>& _files)
+{
+    std::vector<size_t> order;
+    {
+        std::lock_guard<std::mutex> lock(g_execTimeStatsMutex);
+        loadStats();
+        std::vector<string> keys;
+        for (auto const& file : _files)
+            keys.push_back(statsKey(file));
+        order = g_records.longestFirst(keys);
+    }
+
+    std::vector<fs::path> const files = _files;
+    for (size_t i = 0; i < order.size(); i++)
+        _files.at(i) = files.at(order.at(i));
+}
+
+void ExecTimeStats::recordTime(fs::path const& _file, double _seconds)
+{
+    // Time of a single test run is not the time of the file, its tests are recorded
+    if (filteredRun() || !Options::get().singleSubTestName.empty())
+        return;
+    std::lock_guard<std::mutex> lock(g_execTimeStatsMutex);
+    g_folderTimes.push_back({statsKey(_file), _seconds});
+}
+
+void ExecTimeStats::recordTestTime(fs::path const& _file, string const& _testName, double _seconds)
+{
+    if (filteredRun())
+        return;
+    std::lock_guard<std::mutex> lock(g_execTimeStatsMutex);
+    g_folderTestTimes.push_back({ExecTimeRecords::testKey(statsKey(_file), _testName), _seconds});
+}
+
+void ExecTimeStats::finishFolder(string const& _folder, double _wallTime)
+{
+    std::lock_guard<std::mutex> lock(g_execTimeStatsMutex);
+    loadStats();
+
+    double predicted = 0;
+    double actual = 0;
+    size_t unknown = 0;
+    for (auto const& record : g_folderTimes)
+    {
+        double expected = 0;
+        if (g_records.expectedFileTime(record.key, expected))
+            predicted += expected;
+        else
+            unknown++;
+        actual += record.actual;
+    }
+
+    if (Options::get().exectimelog && g_folderTimes.size())
+    {
+        std::cout << "*** Predicted vs actual time of " << _folder << " (" << g_folderTimes.size() << " files";
+        if (unknown)
+            std::cout << ", " << unknown << " without records";
+        std::cout << ")" << std::endl;
+        std::cout << std::left << setw(45) << "Predicted total" << " : " << predicted << std::endl;
+        std::cout << std::left << setw(45) << "Actual total" << " : " << actual << std::endl;
+        std::cout << std::left << setw(45) << "Wall time" << " : " << _wallTime << std::endl;
+        printSlowest(g_folderTimes, 5);
+        if (g_folderTestTimes.size())
+        {
+            std::cout << "*** Slowest tests of " << _folder << std::endl;
+            printSlowest(g_folderTestTimes, 5);
+        }
+    }
+
+    for (auto const& record : g_folderTimes)
+        g_records.update(record.key, record.actual);
+    for (auto const& record : g_folderTestTimes)
+        g_records.update(record.key, record.actual);
+    g_folderTimes.clear();
+    g_folderTestTimes.clear();
+    saveStats();
+}
+
+}  // namespace test
@@ -0,0 +1,63 @@
+#pragma once
+#include <boost/filesystem.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace test
+{
+// Expected execution times by record key, averaged over the runs
+// File records are keyed by the file, test records by the file key and the test name
+class ExecTimeRecords
+{
+public:
+    static std::string testKey(std::string const& _fileKey, std::string const& _testName)
+    {
+        return _fileKey + "/" + _testName;
+    }
+
+    // Read `seconds key` lines, malformed lines are skipped and returned in _malformed
+    void parse(std::string const& _content, std::vector<std::string>& _malformed);
+    std::string serialize() const;
+
+    // Average the actual time with the previous record to smooth out the noise of one run
+    void update(std::string const& _key, double _seconds);
+
+    // Expected time of the record. False if there is no record
+    bool expected(std::string const& _key, double& _seconds) const;
+
+    // Expected time of the file: the file record or the sum of its test records
+    // (a run filtered by --singletest records the tests only)
+    bool expectedFileTime(std::string const& _fileKey, double& _seconds) const;
+
+    // Order of the files, longest expected time first. Files without records go first
+    // Files with equal time keep their order
+    std::vector<size_t> longestFirst(std::vector<std::string> const& _fileKeys) const;
+
+private:
+    std::map<std::string, double> m_expected;  // key => expected seconds
+};
+
+// Execution time of test files and tests stored between the runs in the datadir (exectime.stats)
+// Records are kept per client config and mode (fill/run). runAllTestsInFolder uses them
+// to schedule the longest expected files first, so a slow file does not run alone at the end
+class ExecTimeStats
+{
+public:
+    // Sort files by expected time, longest first. Files without a record go first
+    static void sortLongestFirst(std::vector<boost::filesystem::path>& _files);
+
+    // Record the actual execution time of the file
+    static void recordTime(boost::filesystem::path const& _file, double _seconds);
+
+    // Record the actual execution time of a test of the file
+    static void recordTestTime(boost::filesystem::path const& _file, std::string const& _testName, double _seconds);
+
+    // Store the records of this run and print predicted vs actual time (with --exectimelog)
+    static void finishFolder(std::string const& _folder, double _wallTime);
+
+private:
+    ExecTimeStats() {}
+};
+
+}  // namespace test
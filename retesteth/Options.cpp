@@ -53,9 +53,13 @@ void printHelp()
     cout << setw(40) << "-j <ThreadNumber>" << setw(0) << "Run test execution using threads\n";
     cout << setw(40) << "--clients `client1, client2`" << setw(0)
          << "Use following configurations from datadir path (default: ~/.retesteth)\n";
+    cout << setw(42) << " " << setw(0) << "With -j the clients are tested at the same time\n";
     cout << setw(40) << "--datadir" << setw(0) << "Path to configs (default: ~/.retesteth)\n";
     cout << setw(40) << "--nodes" << setw(0) << "List of client tcp ports (\"addr:ip, addr:ip\")\n";
     cout << setw(42) << " " << setw(0) << "Overrides the config file \"socketAddress\" section \n";
+    cout << setw(40) << "--cachegenesis" << setw(0) << "Keep genesis stateRoots calculated by t8ntool between runs\n";
+    cout << setw(40) << "--cachetests" << setw(0) << "Keep parsed test files in binary form in the datadir between runs\n";
+    cout << setw(40) << "--checkt9n" << setw(0) << "Compare transaction validation of retesteth with t9n tool\n";
     cout << setw(40) << "--help -h" << setw(25) << "Display list of command arguments\n";
     cout << setw(40) << "--version -v" << setw(25) << "Display build information\n";
     cout << setw(40) << "--list" << setw(25) << "Display available test suites\n";
@@ -81,7 +85,7 @@ void printHelp()
     cout << setw(30) << "--limitblocks" << setw(25) << "Limit the block exectuion in blockchain tests for debug\n";
     cout << setw(30) << "--limitrpc" << setw(25) << "Limit the rpc exectuion in tests for debug\n";
     cout << setw(30) << "--verbosity <level>" << setw(25) << "Set logs verbosity. 0 - silent, 1 - only errors, 2 - informative, >2 - detailed\n";
-    cout << setw(30) << "--exectimelog" << setw(25) << "Output execution time for each test suite\n";
+    cout << setw(30) << "--exectimelog" << setw(25) << "Output execution time for each test suite and predicted vs actual time\n";
     cout << setw(30) << "--statediff" << setw(25) << "Trace state difference for state tests\n";
     cout << setw(30) << "--stderr" << setw(25) << "Redirect ipc client stderr to stdout\n";
     cout << setw(30) << "--travisout" << setw(25) << "Output `.` to stdout\n";
@@ -275,6 +279,12 @@ Options::Options(int argc, const char** argv)
         }
         else if (arg == "--exectimelog")
             exectimelog = true;
+        else if (arg == "--cachegenesis")
+            cachegenesis = true;
+        else if (arg == "--cachetests")
+            cachetests = true;
+        else if (arg == "--checkt9n")
+            checkt9n = true;
         else if (arg == "--all")
             all = true;
         else if (arg == "--lowcpu")
@@ -491,9 +501,6 @@ Options::Options(int argc, const char** argv)
             BOOST_THROW_EXCEPTION(
                 InvalidOption("--seed <uint> could be used only with --createRandomTest \n"));
     }
-
-    if (threadCount == 1)
-        dataobject::GCP_SPointer<int>::DISABLETHREADSAFE();
 }
 
 Options const& Options::get(int argc, const char** argv)
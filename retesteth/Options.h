@@ -28,6 +28,13 @@ public:
         size_t activeConfigs() const;
         bool currentConfigIsSet() const;
 
+        // Worker threads run the tasks of different configs at the same time
+        // The config of the thread overrides the current config for the calling thread
+        void setThreadConfig(test::ClientConfigID const& _id);
+
+        // Several configs are tested at the same time on the thread pool
+        bool runConfigsConcurrently() const;
+
     private:
         std::vector<ClientConfig> m_clientConfigs;
         test::ClientConfigID m_currentConfigID = test::ClientConfigID::null();
@@ -55,6 +62,9 @@ public:
     fs::path datadir;         ///< Path to datadir (~/.retesteth)
     std::vector<IPADDRESS> nodesoverride;  ///< ["IP:port", ""IP:port""] array
     bool exectimelog = false; ///< Print execution time for each test suite
+    bool cachegenesis = false; ///< Store calculated genesis stateRoots in the client config folder
+    bool cachetests = false;   ///< Store parsed test files in the datadir (testcache)
+    bool checkt9n = false;     ///< Compare native transaction validation with the t9n tool
 	std::string rCurrentTestSuite; ///< Remember test suite before boost overwrite (for random tests)
     bool statediff = false;        ///< Fill full post state in General tests
     bool fullstate = false;        ///< Replace large state output to it's hash
@@ -91,6 +101,7 @@ public:
 	static Options const& get(int argc = 0, const char** argv = 0);
     static DynamicOptions& getDynamicOptions() { return m_dynamicOptions; }
     static ClientConfig const& getCurrentConfig() { return m_dynamicOptions.getCurrentConfig(); }
+    static fs::path getRetestethDataDir();
     string getGStateTransactionFilter() const;
 
 private:
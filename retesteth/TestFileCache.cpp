@@ -0,0 +1,151 @@
+#include "TestFileCache.h"
+#include <dataObject/ConvertBinary.h>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <sys/stat.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+using namespace dev;
+using namespace dataobject;
+using namespace test;
+namespace fs = boost::filesystem;
+
+namespace
+{
+// Record: magic, source size, source mtime (ns), sha3 of the source, hash of the data, binary DataObject
+string const c_magic = "rtcache1";
+size_t const c_sizeOffset = 8;
+size_t const c_mtimeOffset = 16;
+size_t const c_sourceHashOffset = 24;
+size_t const c_dataHashOffset = 56;
+size_t const c_headerSize = 88;
+
+// Part of the record key, records of another format version are not found
+// Increase it when the record layout, the binary DataObject format or the parser output change
+string const c_formatVersion = "2";
+
+struct SourceStat
+{
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+};
+
+bool statSource(fs::path const& _file, SourceStat& _stat)
+{
+    struct stat st;
+    if (::stat(_file.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        return false;
+    _stat.size = st.st_size;
+#if defined(__APPLE__)
+    _stat.mtime = uint64_t(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    _stat.mtime = uint64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+fs::path recordFile(fs::path const& _file, bool _sorted)
+{
+    string const key = "v" + c_formatVersion + " " + fs::absolute(_file).string() + (_sorted ? " sorted" : "");
+    return Options::getRetestethDataDir() / "testcache" / dev::toString(dev::sha3(key));
+}
+
+void putUint64(string& _out, size_t _offset, uint64_t _value)
+{
+    std::memcpy(&_out[_offset], &_value, sizeof(_value));
+}
+
+uint64_t getUint64(string const& _in, size_t _offset)
+{
+    uint64_t value;
+    std::memcpy(&value, &_in[_offset], sizeof(value));
+    return value;
+}
+
+h256 getHash(string const& _in, size_t _offset)
+{
+    return h256(reinterpret_cast<dev::byte const*>(&_in[_offset]), h256::ConstructFromPointer);
+}
+}  // namespace
+
+namespace test
+{
+bool TestFileCache::load(fs::path const& _file, bool _sorted, spDataObject& _data, h256& _hash)
+{
+    if (!Options::get().cachetests)
+        return false;
+
+    SourceStat source;
+    fs::path const record = recordFile(_file, _sorted);
+    if (!statSource(_file, source) || !fs::exists(record))
+        return false;
+
+    string const content = dev::contentsString(record);
+    if (content.size() < c_headerSize || content.compare(0, c_magic.size(), c_magic) != 0)
+        return false;
+    if (getUint64(content, c_sizeOffset) != source.size)
+        return false;
+
+    if (getUint64(content, c_mtimeOffset) != source.mtime)
+    {
+        // The file was touched (git checkout), compare the content
+        if (dev::sha3(dev::contentsString(_file)) != getHash(content, c_sourceHashOffset))
+            return false;
+        std::fstream out(record.string(), std::ios::in | std::ios::out | std::ios::binary);
+        out.seekp(c_mtimeOffset);
+        out.write(reinterpret_cast<char const*>(&source.mtime), sizeof(source.mtime));
+    }
+
+    try
+    {
+        DataObjectArenaScope arena;
+        _data = ConvertBinaryToData(content.data() + c_headerSize, content.size() - c_headerSize);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_WARNING("Test cache record " + record.string() + " of " + _file.string() + " is broken: " + _ex.what());
+        return false;
+    }
+    _hash = getHash(content, c_dataHashOffset);
+    ETH_LOG("Test cache record used for " + _file.filename().string(), 6);
+    return true;
+}
+
+void TestFileCache::store(fs::path const& _file, bool _sorted, DataObject const& _data, h256 const& _hash)
+{
+    if (!Options::get().cachetests)
+        return;
+
+    // Stat before reading, if the file changes meanwhile the record would not match the new mtime
+    SourceStat source;
+    if (!statSource(_file, source))
+        return;
+    h256 const sourceHash = dev::sha3(dev::contentsString(_file));
+
+    string content(c_headerSize, 0);
+    content.replace(0, c_magic.size(), c_magic);
+    putUint64(content, c_sizeOffset, source.size);
+    putUint64(content, c_mtimeOffset, source.mtime);
+    std::memcpy(&content[c_sourceHashOffset], sourceHash.data(), h256::size);
+    std::memcpy(&content[c_dataHashOffset], _hash.data(), h256::size);
+    content += ConvertDataToBinary(_data);
+
+    fs::path const record = recordFile(_file, _sorted);
+    try
+    {
+        fs::create_directories(record.parent_path());
+        dev::writeFile(record, bytesConstRef(content), true);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_WARNING("Could not store test cache record " + record.string() + ": " + _ex.what());
+    }
+}
+
+}  // namespace test
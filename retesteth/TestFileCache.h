@@ -0,0 +1,26 @@
+#pragma once
+#include <dataObject/DataObject.h>
+#include <libdevcore/FixedHash.h>
+#include <boost/filesystem.hpp>
+
+namespace test
+{
+// Parsed test files stored between the runs in the datadir (testcache) with --cachetests
+// A record keeps the DataObject tree in binary form and the hash of the tree printed as json
+// The record is valid while the size and sha3 of the test file are the same,
+// the sha3 of the file is only calculated when its mtime differs from the record
+class TestFileCache
+{
+public:
+    // Read the record of the file parsed with _sorted option. Returns false if there is no valid record
+    static bool load(boost::filesystem::path const& _file, bool _sorted, dataobject::spDataObject& _data, dev::h256& _hash);
+
+    // Store the record of the parsed file
+    static void store(
+        boost::filesystem::path const& _file, bool _sorted, dataobject::DataObject const& _data, dev::h256 const& _hash);
+
+private:
+    TestFileCache() {}
+};
+
+}  // namespace test
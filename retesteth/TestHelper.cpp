@@ -1,5 +1,4 @@
 #include <BuildInfo.h>
-#include <fcntl.h>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/test/unit_test.hpp>
@@ -8,19 +7,40 @@
 #include <boost/uuid/uuid_io.hpp>          // streaming operators etc
 #include <boost/uuid/uuid_io.hpp>
 
+#include <algorithm>
 #include <csignal>
+#include <fcntl.h>
 #include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
 #include <retesteth/Options.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/dataObject/ConvertFile.h>
 #include <retesteth/dataObject/ConvertYaml.h>
+#include <retesteth/dataObject/JsonWriter.h>
 
 using namespace std;
 namespace fs = boost::filesystem;
 
+namespace
+{
+// Json printed by DataObject::writeJson is absorbed by the hash as it goes
+class SHA3Sink : public DataObjectSink
+{
+public:
+    void write(char const* _data, size_t _size) override { m_hash.update(_data, _size); }
+    dev::h256 hash() { return m_hash.final(); }
+
+private:
+    dev::SHA3Stream m_hash;
+};
+}  // namespace
+
 namespace  test {
 #ifdef JSONCPP
 Json::Value readJson(fs::path const& _file)
@@ -39,15 +59,57 @@ Json::Value readJson(fs::path const& _file)
 }
 #endif
 
+MappedFile::MappedFile(fs::path const& _file)
+{
+    int const fd = open(_file.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw UpwardsException("MappedFile can't open file: " + _file.string());
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            m_map = map;
+            m_data = static_cast<char const*>(map);
+            m_size = st.st_size;
+        }
+    }
+    close(fd);
+
+    // Files that could not be mapped are read into memory
+    if (!m_map)
+    {
+        m_buffer = dev::contentsString(_file);
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_map)
+        munmap(m_map, m_size);
+}
+
 /// Safely read the json file into DataObject
 spDataObject readJsonData(fs::path const& _file, string const& _stopper, bool _autosort)
 {
     try
     {
-        string s = dev::contentsString(_file);
+        MappedFile const file(_file);
+        char const* data = file.data();
+        size_t const size = file.size();
         ETH_ERROR_REQUIRE_MESSAGE(
-            s.length() > 0, "Contents of " + _file.string() + " is empty. Trying to parse empty file. (forgot --filltests?)");
-        return dataobject::ConvertJsoncppStringToData(s, _stopper, _autosort);
+            size > 0, "Contents of " + _file.string() + " is empty. Trying to parse empty file. (forgot --filltests?)");
+        dataobject::DataObjectArenaScope arena;
+        dev::Timer timer;
+        spDataObject res = dataobject::ConvertJsoncppStringToData(data, size, _stopper, _autosort);
+        size_t const speed = size / std::max(timer.elapsed(), 0.000001) / 1000000;
+        ETH_LOG(_file.filename().string() + ": " + fto_string(arena.nodes()) + " nodes in " +
+                    fto_string(arena.slabs()) + " allocations, parsed at " + fto_string(speed) + " MB/s", 6);
+        return res;
     }
     catch (std::exception const& _ex)
     {
@@ -64,7 +126,11 @@ spDataObject readYamlData(fs::path const& _file, bool _sort)
         string s = dev::contentsString(_file);
         ETH_ERROR_REQUIRE_MESSAGE(
             s.length() > 0, "Contents of " + _file.string() + " is empty. Trying to parse empty file. (forgot --filltests?)");
-        return dataobject::ConvertYamlToData(YAML::Load(s), _sort);
+        dataobject::DataObjectArenaScope arena;
+        spDataObject res = dataobject::ConvertYamlToData(YAML::Load(s), _sort);
+        ETH_LOG(_file.filename().string() + ": " + fto_string(arena.nodes()) + " nodes in " +
+                    fto_string(arena.slabs()) + " allocations", 6);
+        return res;
     }
     catch (std::exception const& _ex)
     {
@@ -73,6 +139,30 @@ spDataObject readYamlData(fs::path const& _file, bool _sort)
     }
 }
 
+/// Safely write DataObject as json into the file without building the json string
+void writeJsonData(fs::path const& _file, DataObject const& _data)
+{
+    try
+    {
+        if (!_file.parent_path().empty())
+            fs::create_directories(_file.parent_path());
+        dev::Timer timer;
+        dataobject::writeJsonFile(_file.string(), _data);
+        ETH_LOG(_file.filename().string() + ": written in " + fto_string(size_t(timer.elapsed() * 1000)) + " ms", 6);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_ERROR_MESSAGE(string("\nError when writing file (") + _file.c_str() + ") " + _ex.what());
+    }
+}
+
+dev::h256 sha3Json(DataObject const& _data)
+{
+    SHA3Sink sink;
+    _data.writeJson(sink, 0, false);
+    return sink.hash();
+}
+
 vector<fs::path> getFiles(fs::path const& _dirPath, set<string> const _extentionMask, string const& _particularFile)
 {
     vector<fs::path> files;
@@ -384,13 +474,12 @@ bool checkCmdExist(std::string const& _command)
 }
 
 mutex g_popenmutex;
-string executeCmd(string const& _command, ExecCMDWarning _warningOnEmpty)
+int executeCmd(string const& _command, string& _out)
 {
 #if defined(_WIN32)
     BOOST_ERROR("executeCmd() has not been implemented for Windows.");
-    return "";
+    return -1;
 #else
-    string out;
     char output[1024];
     ETH_FAIL_REQUIRE_MESSAGE(!_command.empty(), "executeCmd: empty argument!");
     if (!test::checkCmdExist(_command))
@@ -403,26 +492,21 @@ string executeCmd(string const& _command, ExecCMDWarning _warningOnEmpty)
     }
     if (fp == NULL || fp == 0)
         ETH_FAIL_MESSAGE("Failed to run " + _command);
-    if (fgets(output, sizeof(output) - 1, fp) == NULL)
-    {
-        if (_warningOnEmpty == ExecCMDWarning::WarningOnEmptyResult)
-            ETH_WARNING("Reading empty result for " + _command);
-    }
-    else
-    {
-        while (true)
-        {
-            out += string(output);
-            if (fgets(output, sizeof(output) - 1, fp) == NULL)
-                break;
-        }
-    }
+    while (fgets(output, sizeof(output) - 1, fp) != NULL)
+        _out += string(output);
+    return pclose(fp);
+#endif
+}
 
-    int exitCode = pclose(fp);
+string executeCmd(string const& _command, ExecCMDWarning _warningOnEmpty)
+{
+    string out;
+    int exitCode = executeCmd(_command, out);
+    if (out.empty() && _warningOnEmpty == ExecCMDWarning::WarningOnEmptyResult)
+        ETH_WARNING("Reading empty result for " + _command);
     if (exitCode != 0 && _warningOnEmpty != ExecCMDWarning::NoWarningNoError)
         ETH_ERROR_MESSAGE("The command '" + _command + "' exited with " + toString(exitCode) + " code.");
     return boost::trim_copy(out);
-#endif
 }
 
 /// Explode string into array of strings by `delim`
@@ -7,6 +7,7 @@
 #include <json/json.h>
 #endif
 #include <dataObject/DataObject.h>
+#include <libdevcore/FixedHash.h>
 #include <retesteth/EthChecks.h>
 #include <retesteth/compiler/Compiler.h>
 #include <retesteth/testStructures/basetypes/BYTES.h>
@@ -22,11 +23,38 @@ namespace test {
 Json::Value readJson(fs::path const& _path);
 #endif
 
+/// Read only memory mapping of a file. The pages are read by the kernel on access and are not
+/// copied into the process memory like with dev::contentsString. A file that can't be mapped
+/// (empty or not a regular file) is read into memory. Throws if the file can't be opened
+class MappedFile
+{
+public:
+    MappedFile(fs::path const& _file);
+    ~MappedFile();
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    char const* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    char const* m_data = nullptr;
+    size_t m_size = 0;
+    void* m_map = nullptr;
+    std::string m_buffer;
+};
+
 /// Safely read the json file into DataObject
 spDataObject readJsonData(
     fs::path const& _file, string const& _stopper = string(), bool _autosort = false);
 spDataObject readYamlData(fs::path const& _file, bool _sort = false);
 
+/// Safely write DataObject as json into the file without building the json string
+void writeJsonData(fs::path const& _file, DataObject const& _data);
+
+/// sha3 of the compact json print of _data (asJson(0, false)) calculated without building the string
+dev::h256 sha3Json(DataObject const& _data);
+
 /// Get files from directory
 std::vector<boost::filesystem::path> getFiles(boost::filesystem::path const& _dirPath, std::set<std::string> _extentionMask, std::string const& _particularFile = {});
 
@@ -70,6 +98,8 @@ enum class ExecCMDWarning
     NoWarningNoError
 };
 std::string executeCmd(std::string const& _command, ExecCMDWarning _warningOnEmpty = ExecCMDWarning::WarningOnEmptyResult);
+/// run system command, return the exit status given by pclose and append the output to _out
+int executeCmd(std::string const& _command, std::string& _out);
 
 // Return the vector of most looking like as _needles strings from the vector
 std::vector<std::string> levenshteinDistance(
@@ -28,6 +28,7 @@
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/Options.h>
 #include <retesteth/ExitHandler.h>
+#include <retesteth/session/Socket.h>
 
 using namespace std;
 using namespace dev;
@@ -51,6 +52,23 @@ mutex g_execTotalErrors;
 static int totalTestsRun = 0;
 static std::map<std::string, std::string> s_failedTestsMap;
 
+// Results of each client when several clients are tested, guarded by g_totalTestsRun
+struct ClientResults
+{
+    size_t testsRun = 0;
+    size_t errors = 0;
+};
+static std::map<std::string, ClientResults> s_clientResults;
+
+// Name of the tested client if several clients are tested, empty string otherwise
+string testedClientName()
+{
+    Options::DynamicOptions const& dynamicOptions = Options::getDynamicOptions();
+    if (dynamicOptions.activeConfigs() > 1 && dynamicOptions.currentConfigIsSet())
+        return dynamicOptions.getCurrentConfig().cfgFile().name();
+    return string();
+}
+
 mutex g_helperThreadMapMutex;
 TestOutputHelper& TestOutputHelper::get()
 {
@@ -107,15 +125,23 @@ bool TestOutputHelper::markError(std::string const& _message)
         }
     }
 
-    // Mark the error
+    // Mark the error, errors of different clients are told apart by the client name
+    string const client = testedClientName();
+    string const clientPrefix = client.empty() ? string() : "(" + client + ") ";
     string const testDebugInfo = m_testInfo.errorDebug();
-    m_errors.push_back(_message + testDebugInfo);
+    m_errors.push_back(clientPrefix + _message + testDebugInfo);
     if (testDebugInfo.empty())
         ETH_WARNING(TestOutputHelper::get().testName() + ", Message: " + _message +
                     ", has empty debugInfo! Missing debug Testinfo for test step.");
+    if (!client.empty())
+    {
+        std::lock_guard<std::mutex> lock(g_totalTestsRun);
+        s_clientResults[client].errors++;
+    }
     std::lock_guard<std::mutex> lock(g_failedTestsMap);
-    if (!s_failedTestsMap.count(TestOutputHelper::get().testName()))
-        s_failedTestsMap[TestOutputHelper::get().testName()] = testDebugInfo;
+    string const failedTest = clientPrefix + TestOutputHelper::get().testName();
+    if (!s_failedTestsMap.count(failedTest))
+        s_failedTestsMap[failedTest] = clientPrefix + testDebugInfo;
     return true;
 }
 
@@ -125,8 +151,15 @@ void TestOutputHelper::unmarkLastError()
 {
     if (m_errors.size())
         m_errors.pop_back();
+    string const client = testedClientName();
+    if (!client.empty())
+    {
+        std::lock_guard<std::mutex> lock(g_totalTestsRun);
+        if (s_clientResults[client].errors > 0)
+            s_clientResults[client].errors--;
+    }
     std::lock_guard<std::mutex> lock(g_failedTestsMap);
-    string const& tname = TestOutputHelper::get().testName();
+    string const tname = (client.empty() ? string() : "(" + client + ") ") + TestOutputHelper::get().testName();
     if (s_failedTestsMap.count(tname))
         s_failedTestsMap.erase(tname);
 }
@@ -168,8 +201,11 @@ void TestOutputHelper::initTest(size_t _maxTests)
 
 void TestOutputHelper::registerTestRunSuccess()
 {
+    string const client = testedClientName();
     std::lock_guard<std::mutex> lock(g_totalTestsRun);
     totalTestsRun++;
+    if (!client.empty())
+        s_clientResults[client].testsRun++;
 }
 
 void TestOutputHelper::showProgress()
@@ -251,6 +287,7 @@ void TestOutputHelper::printTestExecStats()
         std::cout << setw(45) << "Total Time: " << setw(25) << "     : " + fto_string(totalTime) << "\n";
         for (size_t i = 0; i < execTimeResults.size(); i++)
             std::cout << setw(45) << execTimeResults[i].second << setw(25) << " time: " + fto_string(execTimeResults[i].first) << "\n";
+        std::cout << Socket::latencyStats();
         std::cout << "\n";
     }
     else
@@ -263,6 +300,14 @@ void TestOutputHelper::printTestExecStats()
             ETH_STDERROR_MESSAGE(message);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(g_totalTestsRun);
+        for (auto const& client : s_clientResults)
+            std::cout << "*** Client '" << client.first << "': " << client.second.testsRun << " tests run, "
+                      << client.second.errors << " errors\n";
+        s_clientResults.clear();
+    }
+
     bool wereExecErrors = false;
     {
         std::lock_guard<std::mutex> lock(g_execTotalErrors);
@@ -22,7 +22,9 @@
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/SHA3.h>
 #include <retesteth/EthChecks.h>
+#include <retesteth/ExecTimeStats.h>
 #include <retesteth/ExitHandler.h>
+#include <retesteth/TestFileCache.h>
 #include <retesteth/Options.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/testSuites/TestFixtures.h>
@@ -56,10 +58,14 @@ TestFileData readTestFile(fs::path const& _testFileName)
         isLegacy;  //(Options::get().checkhash && isLegacy); uncomment here if there would be too many legacy tests
 
     // Binary file hash calculation is impossible as git messes up with the files
-    // So we read json structure and print it here to calculate the hash from string
+    // So we read json structure and hash its compact json print (without building the string)
     // Adds around 1% to execution time
     ETH_LOG("Read json structure " + string(_testFileName.filename().c_str()), 5);
     TestFileData testData;
+    bool const showhash = test::Options::get().showhash;
+    if (!showhash && TestFileCache::load(_testFileName, bSortOnLoad, testData.data, testData.hash))
+        return testData;
+
     if (_testFileName.extension() == ".json")
         testData.data = test::readJsonData(_testFileName, string(), bSortOnLoad);
     else if (_testFileName.extension() == ".yml")
@@ -82,8 +88,7 @@ TestFileData readTestFile(fs::path const& _testFileName)
         return testData;
     }
 
-    string srcString = testData.data->asJson(0, false); //json_spirit::write_string(testData.data, false);
-    if (test::Options::get().showhash)
+    if (showhash)
     {
         std::string output = "Not a Json object!";
 #ifdef JSONCPP
@@ -99,10 +104,11 @@ TestFileData readTestFile(fs::path const& _testFileName)
 #endif
 
         std::cerr << "JSON: '" << std::endl << output << "'" << std::endl;
-        std::cerr << "DATA: '" << std::endl << srcString << "'" << std::endl;
+        std::cerr << "DATA: '" << std::endl << testData.data->asJson(0, false) << "'" << std::endl;
     }
-    testData.hash = sha3(srcString);
+    testData.hash = sha3Json(testData.data);
     testData.hashCalculated = true;
+    TestFileCache::store(_testFileName, bSortOnLoad, testData.data, testData.hash);
     return testData;
 }
 
@@ -151,8 +157,7 @@ bool addClientInfo(
 
         testInGeneratedRef.removeKey("_info");
         testInGeneratedRef.performModifier(mod_sortKeys);
-        string filledTestHashStr = testInGeneratedRef.asJson(0, false);
-        (*clientinfo)["generatedTestHash"] = dev::toString(sha3(filledTestHashStr));
+        (*clientinfo)["generatedTestHash"] = dev::toString(sha3Json(testInGeneratedRef));
         (*clientinfo)["sourceHash"] = toString(_testSourceHash);
 
         // See if we actually changed something in the test after regeneration
@@ -316,7 +321,7 @@ void TestSuite::runTestWithoutFiller(boost::filesystem::path const& _file) const
                     spDataObject output = doTests(testData.data, opt);
                     addClientInfo(output.getContent(), _file, testData.hash, outPath);
                     (*output).performModifier(mod_sortKeys, DataObject::ModifierOption::NONRECURSIVE);
-                    writeFile(outPath, asBytes(output->asJson()));
+                    writeJsonData(outPath, output);
                 }
                 else
                     executeFile(_file);
@@ -511,37 +516,89 @@ void TestSuite::runAllTestsInFolder(string const& _testFolder) const
     }
 
 
-    // repeat this part for all connected clients
-    auto thisPart = [this, &files, &_testFolder]() {
-        auto& testOutput = test::TestOutputHelper::get();
+    // Files that took the longest time in previous runs go first
+    vector<fs::path> scheduledFiles;
+    for (auto const& file : files)
+    {
+        if (Options::get().lowcpu && TestChecker::isCPUIntenseTest(file.stem().string()))
+            ETH_WARNING("Skipping " + file.stem().string() + " because --lowcpu option was specified.\n");
+        else
+            scheduledFiles.push_back(file);
+    }
+    if (Options::get().threadCount > 1)
+        ExecTimeStats::sortLongestFirst(scheduledFiles);
 
+    // Flush the clients of the current config if needed
+    auto restartLongRunningClients = [&_testFolder]() {
         if (RPCSession::isRunningTooLong() || TestChecker::isTimeConsumingTest(_testFolder.c_str()))
             RPCSession::restartScripts(true);
+    };
+
+    // Add the task of the file, it runs with the current config
+    auto addFileTask = [this, &_testFolder](fs::path const& _file) {
+        test::TestOutputHelper::get().showProgress();
+        if (ExitHandler::receivedExitSignal())
+            return;
+
+        auto job = [this, &_testFolder, &_file](){
+            dev::Timer fileTimer;
+            executeTest(_testFolder, _file);
+            ExecTimeStats::recordTime(_file, fileTimer.elapsed());
+        };
+        ThreadManager::addTask(job);
+    };
 
+    // repeat this part for all connected clients
+    auto thisPart = [&scheduledFiles, &files, &_testFolder, &restartLongRunningClients, &addFileTask]() {
+        auto& testOutput = test::TestOutputHelper::get();
+        restartLongRunningClients();
+
+        dev::Timer folderTimer;
         testOutput.initTest(files.size());
-        for (auto const& file : files)
+        for (auto const& file : scheduledFiles)
         {
             if (ExitHandler::receivedExitSignal())
                 break;
-            if (Options::get().lowcpu && TestChecker::isCPUIntenseTest(file.stem().string()))
-            {
-                ETH_WARNING("Skipping " + file.stem().string() + " because --lowcpu option was specified.\n");
-                continue;
-            }
-
-            testOutput.showProgress();
-            if (ExitHandler::receivedExitSignal())
-                break;
-
-            auto job = [this, &_testFolder, &file](){
-                executeTest(_testFolder, file);
-            };
-            ThreadManager::addTask(job);
+            addFileTask(file);
         }
         ThreadManager::joinThreads();
+        ExecTimeStats::finishFolder(_testFolder, folderTimer.elapsed());
         testOutput.finishTest();
     };
-    runFunctionForAllClients(thisPart);
+
+    if (!Options::getDynamicOptions().runConfigsConcurrently())
+    {
+        runFunctionForAllClients(thisPart);
+        return;
+    }
+
+    // Tasks of all clients share the thread pool, so the clients run at the same time
+    // The files are interleaved between the clients for each client to start right away
+    auto& testOutput = test::TestOutputHelper::get();
+    auto const& configs = Options::getDynamicOptions().getClientConfigs();
+    for (auto const& config : configs)
+    {
+        Options::getDynamicOptions().setCurrentConfig(config);
+        std::cout << "Running tests for config '" << config.cfgFile().name() << "' " << config.getId().id()
+                  << " concurrently" << std::endl;
+        restartLongRunningClients();
+    }
+
+    dev::Timer folderTimer;
+    testOutput.initTest(files.size() * configs.size());
+    for (auto const& file : scheduledFiles)
+    {
+        for (auto const& config : configs)
+        {
+            if (ExitHandler::receivedExitSignal())
+                break;
+            Options::getDynamicOptions().setCurrentConfig(config);
+            addFileTask(file);
+        }
+    }
+    ThreadManager::joinThreads();
+    ExecTimeStats::finishFolder(_testFolder, folderTimer.elapsed());
+    testOutput.finishTest();
 }
 
 
@@ -635,7 +692,7 @@ void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFile
                 ETH_LOG(" TO " + boostTestPath.path().string(), 0);
                 assert(_testFileName.string() != boostTestPath.path().string());
                 addClientInfo(testData.data.getContent(), boostRelativeTestPath, testData.hash, boostTestPath.path());
-                writeFile(boostTestPath.path(), asBytes(testData.data->asJson()));
+                writeJsonData(boostTestPath.path(), testData.data);
                 ETH_FAIL_REQUIRE_MESSAGE(boost::filesystem::exists(boostTestPath.path().string()),
                     "Error when copying the test file!");
             }
@@ -653,7 +710,7 @@ void TestSuite::executeTest(string const& _testFolder, fs::path const& _testFile
                     if (update)
                     {
                         (*output).performModifier(mod_sortKeys, DataObject::ModifierOption::NONRECURSIVE);
-                        writeFile(boostTestPath.path(), asBytes(output->asJson()));
+                        writeJsonData(boostTestPath.path(), output);
                     }
 
                     if (!Options::get().getGStateTransactionFilter().empty())
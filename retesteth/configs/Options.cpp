@@ -9,9 +9,7 @@ using namespace std;
 using namespace test;
 namespace fs = boost::filesystem;
 
-namespace
-{
-fs::path getRetestethDataDir()
+fs::path Options::getRetestethDataDir()
 {
     fs::path dataDir = Options::get().datadir;
     if (dataDir.empty())
@@ -21,7 +19,6 @@ fs::path getRetestethDataDir()
         ETH_LOG("Options path `" + dataDir.string() + "` doesn't exist, attempt to create a new directory", 3);
     return dataDir;
 }
-}  // namespace
 
 string prepareRetestethVersion()
 {
@@ -44,6 +41,9 @@ void deployFirstRunConfigs(fs::path const& _dir)
     }
 }
 
+// Config of the worker thread, 0 if the thread uses the current config
+static thread_local unsigned t_threadConfigID = 0;
+
 size_t Options::DynamicOptions::activeConfigs() const
 {
     return m_clientConfigs.size();
@@ -51,14 +51,25 @@ size_t Options::DynamicOptions::activeConfigs() const
 
 bool Options::DynamicOptions::currentConfigIsSet() const
 {
-    return m_currentConfigID.id() != ClientConfigID::null().id();
+    return t_threadConfigID != 0 || m_currentConfigID.id() != ClientConfigID::null().id();
+}
+
+bool Options::DynamicOptions::runConfigsConcurrently() const
+{
+    return m_clientConfigs.size() > 1 && Options::get().threadCount > 1;
+}
+
+void Options::DynamicOptions::setThreadConfig(ClientConfigID const& _id)
+{
+    t_threadConfigID = _id == ClientConfigID::null() ? 0 : _id.id();
 }
 
 ClientConfig const& Options::DynamicOptions::getCurrentConfig() const
 {
+    unsigned const id = t_threadConfigID != 0 ? t_threadConfigID : m_currentConfigID.id();
     for (auto const& cfg : m_clientConfigs)
     {
-        if (cfg.getId() == m_currentConfigID)
+        if (cfg.getId().id() == id)
             return cfg;
     }
     ETH_FAIL_MESSAGE("ERROR: current config not found! (DynamicOptions::getCurrentConfig())");
@@ -7,6 +7,7 @@ string const t8ntool_config = R"({
     "socketType" : "tranition-tool",
     "socketAddress" : "start.sh",
     "checkLogsHash" : true,
+    "toolMode" : "files",
     "forks" : [
         "Frontier",
         "Homestead",
@@ -0,0 +1,190 @@
+#include <dataObject/ConvertBinary.h>
+#include <dataObject/Exception.h>
+#include <cstdint>
+
+// Node: header byte (type | autosort << 4 | overwrite << 5), key, value
+// String value: length and bytes, Integer: zigzag varint, Bool: one byte
+// Array and Object: number of subobjects followed by the subobjects
+// Lengths and numbers are LEB128 varints
+
+namespace dataobject
+{
+namespace
+{
+uint8_t const c_typeMask = 0x0f;
+uint8_t const c_autosortFlag = 0x10;
+uint8_t const c_overwriteFlag = 0x20;
+string const c_binaryError = "ConvertBinaryToData: ";
+
+void writeVarint(string& _out, uint64_t _value)
+{
+    while (_value >= 0x80)
+    {
+        _out.push_back(char(uint8_t(_value) | 0x80));
+        _value >>= 7;
+    }
+    _out.push_back(char(_value));
+}
+
+void writeString(string& _out, string const& _str)
+{
+    writeVarint(_out, _str.size());
+    _out.append(_str);
+}
+
+void writeNode(string& _out, DataObject const& _node)
+{
+    uint8_t header = uint8_t(_node.type());
+    if (_node.isAutosort())
+        header |= c_autosortFlag;
+    if (_node.isOverwritable())
+        header |= c_overwriteFlag;
+    _out.push_back(char(header));
+    writeString(_out, _node.getKey());
+
+    switch (_node.type())
+    {
+    case DataType::String:
+        writeString(_out, _node.asString());
+        break;
+    case DataType::Integer:
+    {
+        uint32_t const value = uint32_t(_node.asInt());
+        writeVarint(_out, (value << 1) ^ (value & 0x80000000 ? 0xffffffff : 0));
+        break;
+    }
+    case DataType::Bool:
+        _out.push_back(_node.asBool() ? 1 : 0);
+        break;
+    case DataType::Array:
+    case DataType::Object:
+        writeVarint(_out, _node.getSubObjects().size());
+        for (auto const& el : _node.getSubObjects())
+            writeNode(_out, el.getCContent());
+        break;
+    case DataType::Null:
+    case DataType::NotInitialized:
+        break;
+    }
+}
+
+class BinaryReader
+{
+public:
+    BinaryReader(char const* _data, size_t _size) : m_data(_data), m_size(_size) {}
+
+    spDataObject readNode()
+    {
+        uint8_t const header = readByte();
+        uint8_t const type = header & c_typeMask;
+        if (type > DataType::NotInitialized)
+            throw DataObjectException() << c_binaryError + "unknown node type " + to_string(type);
+
+        spDataObject obj;
+        DataObject& node = obj.getContent();
+        readString(node.getKeyUnsafe());
+        switch (type)
+        {
+        case DataType::String:
+            node.setString(string());
+            readString(node.asStringUnsafe());
+            break;
+        case DataType::Integer:
+        {
+            uint32_t const value = uint32_t(readVarint());
+            node.setInt(int((value >> 1) ^ (0 - (value & 1))));
+            break;
+        }
+        case DataType::Bool:
+            node.setBool(readByte() != 0);
+            break;
+        case DataType::Array:
+        case DataType::Object:
+        {
+            // autosort is set after the subobjects are added, they are stored in the final order
+            node.clearSubobjects(DataType(type));
+            size_t const count = readVarint();
+            // each subobject takes at least two bytes
+            if (count > (m_size - m_pos) / 2)
+                throw DataObjectException() << c_binaryError + "wrong number of subobjects at " + to_string(m_pos);
+            node.getSubObjectsUnsafe().reserve(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                spDataObject el = readNode();
+                bool const autosort = el->isAutosort();
+                bool const overwrite = el->isOverwritable();
+                if (type == DataType::Array)
+                    node.addArrayObject(el);
+                else
+                    node.addSubObject(el);
+                DataObject& added = node.atLastElementUnsafe();
+                added.setAutosort(autosort);
+                added.setOverwrite(overwrite);
+            }
+            break;
+        }
+        case DataType::Null:
+            node.clearSubobjects(DataType::Null);
+            break;
+        default:
+            break;
+        }
+        node.setAutosort(header & c_autosortFlag);
+        node.setOverwrite(header & c_overwriteFlag);
+        return obj;
+    }
+
+    bool finished() const { return m_pos == m_size; }
+
+private:
+    uint8_t readByte()
+    {
+        if (m_pos >= m_size)
+            throw DataObjectException() << c_binaryError + "unexpected end of data";
+        return uint8_t(m_data[m_pos++]);
+    }
+
+    uint64_t readVarint()
+    {
+        uint64_t value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t const byte = readByte();
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        throw DataObjectException() << c_binaryError + "varint is too long at " + to_string(m_pos);
+    }
+
+    void readString(string& _out)
+    {
+        uint64_t const length = readVarint();
+        if (length > m_size - m_pos)
+            throw DataObjectException() << c_binaryError + "string is out of data at " + to_string(m_pos);
+        _out.assign(m_data + m_pos, length);
+        m_pos += length;
+    }
+
+    char const* m_data;
+    size_t m_size;
+    size_t m_pos = 0;
+};
+}  // namespace
+
+std::string ConvertDataToBinary(DataObject const& _input)
+{
+    string out;
+    writeNode(out, _input);
+    return out;
+}
+
+spDataObject ConvertBinaryToData(char const* _data, size_t _size)
+{
+    BinaryReader reader(_data, _size);
+    spDataObject res = reader.readNode();
+    if (!reader.finished())
+        throw DataObjectException() << c_binaryError + "unexpected data after the root object";
+    return res;
+}
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <dataObject/DataObject.h>
+
+namespace dataobject
+{
+/// Compact binary form of DataObject tree (used by the test file cache)
+/// Keeps the order of the subobjects, types and the autosort/overwrite flags of each node
+std::string ConvertDataToBinary(DataObject const& _input);
+
+/// Restore DataObject tree from _size bytes at _data written by ConvertDataToBinary
+/// Throws DataObjectException if the data is truncated or corrupted
+spDataObject ConvertBinaryToData(char const* _data, size_t _size);
+}
@@ -1,12 +1,41 @@
 #include <iostream>
 #include <dataObject/ConvertFile.h>
 #include <dataObject/Exception.h>
+#include <cstring>
 // Manually construct dataobject from file string content
 // bacuse Json::Reader::parse has a memory leak
 
 namespace dataobject
 {
 string const errorPrefix = "Error parsing json: ";
+
+namespace
+{
+// Json text of a string or of a memory mapped file
+struct JsonText
+{
+    char const* data;
+    size_t size;
+
+    size_t length() const { return size; }
+    // Like std::string, the position after the last char reads as '\0'
+    char operator[](size_t _i) const { return _i < size ? data[_i] : '\0'; }
+    char at(size_t _i) const
+    {
+        if (_i >= size)
+            throw std::out_of_range("JsonText::at");
+        return data[_i];
+    }
+    size_t find(char _char, size_t _pos) const
+    {
+        if (_pos >= size)
+            return string::npos;
+        void const* found = std::memchr(data + _pos, _char, size - _pos);
+        return found ? static_cast<char const*>(found) - data : string::npos;
+    }
+    string substr(size_t _pos, size_t _count) const { return string(data + _pos, std::min(_count, size - _pos)); }
+};
+
 bool isEmptyChar(char const& _char)
 {
     if (_char == ' ' || _char == '\n' || _char == '\r' || _char == '\t')
@@ -14,7 +43,7 @@ bool isEmptyChar(char const& _char)
     return false;
 }
 
-size_t stripSpaces(string const& _input, size_t _i)
+size_t stripSpaces(JsonText const& _input, size_t _i)
 {
     size_t i = _i;
     for (; i < _input.length(); i++)
@@ -27,14 +56,14 @@ size_t stripSpaces(string const& _input, size_t _i)
     return i;
 }
 
-string parseKeyValue(string const& _input, size_t& _i)
+string parseKeyValue(JsonText const& _input, size_t& _i)
 {
-    if (_i + 1 > _input.size())
+    if (_i + 1 > _input.size)
         throw DataObjectException() << errorPrefix + "reached EOF before reading char: `\"`";
 
     bool escapeChar = true;
     size_t endPos = _input.find('"', _i + 1);
-    while (escapeChar)
+    while (escapeChar && endPos != string::npos)
     {
         escapeChar = (_input[endPos - 1] == '\\');
         if (escapeChar)
@@ -52,9 +81,9 @@ string parseKeyValue(string const& _input, size_t& _i)
     return string();
 }
 
-bool readBoolOrNull(string const& _input, size_t& _i, bool& _result, bool& _readNull)
+bool readBoolOrNull(JsonText const& _input, size_t& _i, bool& _result, bool& _readNull)
 {
-    if (_i + 4 >= _input.size())
+    if (_i + 4 >= _input.size)
         return false;
 
     // true false
@@ -83,7 +112,7 @@ bool readBoolOrNull(string const& _input, size_t& _i, bool& _result, bool& _read
     return false;
 }
 
-bool readDigit(string const& _input, size_t& _i, int& _result)
+bool readDigit(JsonText const& _input, size_t& _i, int& _result)
 {
     bool readMinus = false;
     auto const& e = _input[_i];
@@ -120,7 +149,7 @@ bool readDigit(string const& _input, size_t& _i, int& _result)
     return false;
 }
 
-bool checkExcessiveComa(string const& _input, size_t _i)
+bool checkExcessiveComa(JsonText const& _input, size_t _i)
 {
     if (_i < 1)
         return false;
@@ -131,12 +160,19 @@ bool checkExcessiveComa(string const& _input, size_t _i)
         return true;
     return false;
 }
+}  // namespace
 
 /// Convert Json object represented as string to DataObject
 spDataObject ConvertJsoncppStringToData(
-    std::string const& _input, string const& _stopper, bool _autosort)
+    std::string const& _string, string const& _stopper, bool _autosort)
 {
-    if (_input.size() < 2 || _input.find("{") == string::npos || _input.find("}") == string::npos)
+    return ConvertJsoncppStringToData(_string.data(), _string.size(), _stopper, _autosort);
+}
+
+spDataObject ConvertJsoncppStringToData(char const* _data, size_t _size, string const& _stopper, bool _autosort)
+{
+    JsonText const _input = {_data, _size};
+    if (_input.size < 2 || _input.find('{', 0) == string::npos || _input.find('}', 0) == string::npos)
         throw DataObjectException() << "ConvertJsoncppStringToData can't read json structure in file: `" + _input.substr(0, 50);
 
     std::vector<DataObject*> applyDepth;  // indexes at root array of objects that we are reading into
@@ -180,23 +216,14 @@ spDataObject ConvertJsoncppStringToData(
                     throw DataObjectException()
                         << errorPrefix + "array could not have elements with keys! around: " + printDebug(i);
                 (*obj).setKey(key);
-                bool replaceKey = false;
-                const size_t keyPosExpected = _autosort ?
-                                            max(0, (int)findOrderedKeyPosition(key, actualRoot->getSubObjects()) - 1) : 0;
-                for (size_t objI = keyPosExpected; objI < actualRoot->getSubObjects().size(); objI++)
+                if (actualRoot->count(key))
                 {
-                    if (actualRoot->getSubObjects().at(objI)->getKey() == key)
-                    {
-                        replaceKey = true;
-                        applyDepth.push_back(actualRoot);
-                        actualRoot = &actualRoot->getSubObjectsUnsafe().at(objI).getContent();
-                        actualRoot->clearSubobjects();
-                        break;
-                    }
-                }
-
-                if (replaceKey)
+                    // Repeated key replaces the value
+                    applyDepth.push_back(actualRoot);
+                    actualRoot = &actualRoot->atKeyUnsafe(key);
+                    actualRoot->clearSubobjects();
                     continue;
+                }
                 applyDepth.push_back(actualRoot);  // remember the header
                 actualRoot = &actualRoot->addSubObject(obj);
                 actualRoot->setAutosort(_autosort);
@@ -234,8 +261,7 @@ spDataObject ConvertJsoncppStringToData(
                 continue;
             }
 
-            actualRoot->addSubObject(spDataObject());
-            actualRoot->getSubObjectsUnsafe().pop_back();
+            actualRoot->clearSubobjects(DataType::Object);
             continue;
         }
         if (_input.at(i) == '[')
@@ -252,8 +278,7 @@ spDataObject ConvertJsoncppStringToData(
                 continue;
             }
 
-            actualRoot->addArrayObject(spDataObject());
-            actualRoot->getSubObjectsUnsafe().pop_back();
+            actualRoot->clearSubobjects(DataType::Array);
             continue;
         }
 
@@ -278,7 +303,7 @@ spDataObject ConvertJsoncppStringToData(
                 i++;
                 i = stripSpaces(_input, i);
                 if (i != _input.length())
-                    throw DataObjectException() << errorPrefix + "expected end of json! " + _input;
+                    throw DataObjectException() << errorPrefix + "expected end of json! " + _input.substr(0, _input.size);
                 return root;
             }
             else
@@ -6,4 +6,9 @@ namespace dataobject
 /// Convert Json object represented as string to DataObject
 spDataObject ConvertJsoncppStringToData(
     std::string const& _input, string const& _stopper = string(), bool _setAutosort = false);
+
+/// Convert Json text of _size bytes at _data (memory mapped file) to DataObject
+/// The text is not referenced by the result
+spDataObject ConvertJsoncppStringToData(
+    char const* _data, size_t _size, string const& _stopper = string(), bool _setAutosort = false);
 }
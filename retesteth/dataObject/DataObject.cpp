@@ -1,10 +1,163 @@
 #include <dataObject/DataObject.h>
+#include <dataObject/JsonWriter.h>
 #include <math.h>
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
 using namespace dataobject;
 
+namespace
+{
+size_t const c_arenaAlign = alignof(std::max_align_t);
+size_t const c_firstSlabSize = 64 * 1024;
+size_t const c_maxSlabSize = 1024 * 1024;
+
+// Objects with more children than that are looked up with the hash index
+size_t const c_keyIndexThreshold = 16;
+size_t const c_noPos = size_t(-1);
+
+// A dirty key index is rebuilt by the first lookup, const lookups too
+// Shared documents (genesis templates) are read from several threads, so the rebuild is locked
+std::mutex g_keyIndexMutex;
+
+// Address ranges of the arena slabs by the slab end, nodes carry no arena pointer
+// A node is deleted on any thread, so the lookup is locked. Without arenas it is skipped
+struct SlabRange
+{
+    uintptr_t begin;
+    DataObjectArena* arena;
+};
+std::map<uintptr_t, SlabRange> g_arenaSlabs;
+std::atomic<size_t> g_arenaSlabCount{0};
+std::mutex g_arenaSlabsMutex;
+
+void registerSlab(char const* _slab, size_t _size, DataObjectArena* _arena)
+{
+    std::lock_guard<std::mutex> lock(g_arenaSlabsMutex);
+    uintptr_t const begin = reinterpret_cast<uintptr_t>(_slab);
+    g_arenaSlabs[begin + _size] = {begin, _arena};
+    g_arenaSlabCount.fetch_add(1, std::memory_order_release);
+}
+
+void unregisterSlab(char const* _slab, size_t _size)
+{
+    std::lock_guard<std::mutex> lock(g_arenaSlabsMutex);
+    g_arenaSlabs.erase(reinterpret_cast<uintptr_t>(_slab) + _size);
+    g_arenaSlabCount.fetch_sub(1, std::memory_order_release);
+}
+
+// The arena the node was taken from, nullptr for the heap nodes
+DataObjectArena* findArena(void const* _ptr)
+{
+    if (g_arenaSlabCount.load(std::memory_order_acquire) == 0)
+        return nullptr;
+    uintptr_t const ptr = reinterpret_cast<uintptr_t>(_ptr);
+    std::lock_guard<std::mutex> lock(g_arenaSlabsMutex);
+    auto const it = g_arenaSlabs.upper_bound(ptr);
+    if (it == g_arenaSlabs.end() || it->second.begin > ptr)
+        return nullptr;
+    return it->second.arena;
+}
+}  // namespace
+
+namespace dataobject
+{
+// Bump allocator for the nodes of one document, the memory of deleted nodes is not reused
+// The arena is referenced by the open scope and by each allocated node
+class DataObjectArena
+{
+public:
+    ~DataObjectArena()
+    {
+        for (auto const& slab : m_slabs)
+            unregisterSlab(slab.first.get(), slab.second);
+    }
+    void* allocate(size_t _size)
+    {
+        size_t const size = (_size + c_arenaAlign - 1) / c_arenaAlign * c_arenaAlign;
+        if (m_slabs.empty() || m_used + size > m_slabSize)
+        {
+            // Big test files grow the slabs
+            m_slabSize = std::max(size, std::min(c_maxSlabSize, m_slabs.empty() ? c_firstSlabSize : m_slabSize * 2));
+            m_slabs.emplace_back(std::unique_ptr<char[]>(new char[m_slabSize]), m_slabSize);
+            registerSlab(m_slabs.back().first.get(), m_slabSize, this);
+            m_used = 0;
+        }
+        void* ptr = m_slabs.back().first.get() + m_used;
+        m_used += size;
+        m_nodes++;
+        m_refs.fetch_add(1, std::memory_order_relaxed);
+        return ptr;
+    }
+    void release()
+    {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+    size_t nodes() const { return m_nodes; }
+    size_t slabs() const { return m_slabs.size(); }
+
+private:
+    std::vector<std::pair<std::unique_ptr<char[]>, size_t>> m_slabs;
+    size_t m_slabSize = 0;
+    size_t m_used = 0;
+    size_t m_nodes = 0;
+    std::atomic<size_t> m_refs{1};
+};
+
+// Open addressing table of child positions, the keys are stored only in the children
+struct DataObjectKeyIndex
+{
+    struct Slot
+    {
+        size_t hash;
+        size_t pos;
+    };
+    std::vector<Slot> slots;
+    size_t used = 0;
+};
+}  // namespace dataobject
+
+namespace
+{
+thread_local DataObjectArena* t_arena = nullptr;
+}  // namespace
+
+DataObjectArenaScope::DataObjectArenaScope() : m_arena(new DataObjectArena()), m_previous(t_arena)
+{
+    t_arena = m_arena;
+}
+
+DataObjectArenaScope::~DataObjectArenaScope()
+{
+    t_arena = m_previous;
+    m_arena->release();
+}
+
+size_t DataObjectArenaScope::nodes() const { return m_arena->nodes(); }
+size_t DataObjectArenaScope::slabs() const { return m_arena->slabs(); }
+bool DataObjectArenaScope::isOpen() { return t_arena != nullptr; }
+
+void* DataObject::operator new(size_t _size)
+{
+    return t_arena ? t_arena->allocate(_size) : ::operator new(_size);
+}
+
+void DataObject::operator delete(void* _ptr)
+{
+    if (_ptr == nullptr)
+        return;
+    if (DataObjectArena* arena = findArena(_ptr))
+        arena->release();
+    else
+        ::operator delete(_ptr);
+}
+
 /// Default dataobject is null
 DataObject::DataObject() { m_type = DataType::NotInitialized; }
 
@@ -45,15 +198,41 @@ DataObject::DataObject(DataType type, bool _bool)
     m_type = type;
 }
 
+DataObject::~DataObject() {}
+
 /// Get dataobject type
 DataType DataObject::type() const { return m_type; }
 
 /// Set key of the dataobject
-void DataObject::setKey(std::string const& _key) { m_strKey = _key; }
+void DataObject::setKey(std::string const& _key)
+{
+    if (_key != m_strKey)
+        keepLookupKey();
+    m_strKey = _key;
+}
+
+/// The parent finds the node by the key it was added with, as with the old key map
+/// A node renamed in place (setKey, replace) keeps its old key for the lookups
+void DataObject::keepLookupKey()
+{
+    if (!m_lookupKey && !m_strKey.empty())
+        m_lookupKey.reset(new std::string(m_strKey));
+}
+
+/// Key of the node set by the parent (addSubObject, renameKey), the node is found by it
+void DataObject::setRegisteredKey(std::string const& _key)
+{
+    m_strKey = _key;
+    m_lookupKey.reset();
+}
 
 /// Get key of the dataobject
 std::string const& DataObject::getKey() const { return m_strKey; }
-std::string& DataObject::getKeyUnsafe() { return m_strKey; }
+std::string& DataObject::getKeyUnsafe()
+{
+    keepLookupKey();
+    return m_strKey;
+}
 
 /// Get vector of subobjects
 std::vector<spDataObject> const& DataObject::getSubObjects() const
@@ -61,15 +240,11 @@ std::vector<spDataObject> const& DataObject::getSubObjects() const
     return m_subObjects;
 }
 
-/// Get map of keys to subobjects
-std::map<string, spDataObject> const& DataObject::getSubObjectKeys() const
-{
-    return m_subObjectKeys;
-}
-
 /// Get ref vector of subobjects
 std::vector<spDataObject>& DataObject::getSubObjectsUnsafe()
 {
+    // The caller could add, remove or reorder subobjects
+    m_keyIndexDirty.store(true, std::memory_order_relaxed);
     return m_subObjects;
 }
 
@@ -90,14 +265,16 @@ void DataObject::setSubObjectKey(size_t _index, std::string const& _key)
 {
     _assert(_index < m_subObjects.size(), "_index < m_subObjects.size() (DataObject::setSubObjectKey)");
     if (m_subObjects.size() > _index)
-        m_subObjects.at(_index).getContent().setKey(_key);
+        m_subObjects.at(_index).getContent().setRegisteredKey(_key);
+    if (m_keyIndex)
+        buildKeyIndex();
 }
 
 
 /// look if there is a subobject with _key
 bool DataObject::count(std::string const& _key) const
 {
-    return m_subObjectKeys.count(_key);
+    return findKeyPos(_key) != c_noPos;
 }
 
 /// Get string value
@@ -134,18 +311,9 @@ void DataObject::setKeyPos(std::string const& _key, size_t _pos)
     _assert(count(_key), "count(_key) _key = " + _key + " (DataObject::setKeyPos)");
     _assert(!_key.empty(), "!_key.empty() (DataObject::setKeyPos)");
 
-    size_t elementPos = 0;
-    for (size_t i = 0; i < m_subObjects.size(); i++)
-        if (m_subObjects.at(i)->getKey() == _key)
-        {
-            if (i == _pos)
-                return;  // item already at _pos;
-            else
-            {
-                elementPos = i;
-                break;
-            }
-        }
+    size_t const elementPos = findKeyPos(_key);
+    if (elementPos == _pos)
+        return;  // item already at _pos;
 
     setOverwrite(true);
     spDataObject data = m_subObjects.at(elementPos);
@@ -155,13 +323,15 @@ void DataObject::setKeyPos(std::string const& _key, size_t _pos)
     else
         m_subObjects.insert(m_subObjects.begin() + _pos, 1, data);
     setOverwrite(false);
+    if (m_keyIndex)
+        buildKeyIndex();
 }
 
 
 /// replace this object with _value
 void DataObject::replace(DataObject const& _value)
 {
-    m_strKey = _value.getKey();
+    setKey(_value.getKey());
     switch (_value.type())
     {
     case DataType::String:
@@ -180,7 +350,7 @@ void DataObject::replace(DataObject const& _value)
     m_type = _value.type();
     m_subObjects.clear();
     m_subObjects = _value.getSubObjects();
-    m_subObjectKeys = _value.getSubObjectKeys();
+    buildKeyIndex();
     m_allowOverwrite = _value.isOverwritable();
     setAutosort(_value.isAutosort());
 }
@@ -201,10 +371,9 @@ DataObjectK& DataObjectK::operator=(spDataObject const& _value)
 
 spDataObject& DataObject::atKeyPointerUnsafe(std::string const& _key)
 {
-    if (m_subObjectKeys.count(_key))
-        return m_subObjectKeys.at(_key);
-    _assert(false, "count(_key) _key=" + _key + " (DataObject::atKeyPointerUnsafe)");
-    return m_subObjectKeys.at(0);
+    size_t const pos = findKeyPos(_key);
+    _assert(pos != c_noPos, "count(_key) _key=" + _key + " (DataObject::atKeyPointerUnsafe)");
+    return m_subObjects.at(pos);
 }
 
 DataObjectK DataObject::atKeyPointer(std::string const& _key)
@@ -214,19 +383,16 @@ DataObjectK DataObject::atKeyPointer(std::string const& _key)
 
 DataObject const& DataObject::atKey(std::string const& _key) const
 {
-    if (m_subObjectKeys.count(_key))
-        return m_subObjectKeys.at(_key).getCContent();
-
-    _assert(false, "count(_key) _key=" + _key + " (DataObject::atKey)");
-    return m_subObjects.at(0).getCContent();
+    size_t const pos = findKeyPos(_key);
+    _assert(pos != c_noPos, "count(_key) _key=" + _key + " (DataObject::atKey)");
+    return m_subObjects.at(pos).getCContent();
 }
 
 DataObject& DataObject::atKeyUnsafe(std::string const& _key)
 {
-    if (m_subObjectKeys.count(_key))
-        return m_subObjectKeys.at(_key).getContent();
-    _assert(false, "count(_key) _key=" + _key + " (DataObject::atKeyUnsafe)");
-    return m_subObjects.at(0).getContent();
+    size_t const pos = findKeyPos(_key);
+    _assert(pos != c_noPos, "count(_key) _key=" + _key + " (DataObject::atKeyUnsafe)");
+    return m_subObjects.at(pos).getContent();
 }
 
 DataObject const& DataObject::at(size_t _pos) const
@@ -265,33 +431,29 @@ void DataObject::addArrayObject(spDataObject const& _obj)
 void DataObject::renameKey(std::string const& _currentKey, std::string const& _newKey)
 {
     if (m_strKey == _currentKey)
-        m_strKey = _newKey;
+        setKey(_newKey);
 
-    if (m_subObjectKeys.count(_currentKey))
+    size_t const pos = findKeyPos(_currentKey);
+    if (pos != c_noPos)
     {
-        spDataObject data = m_subObjectKeys.at(_currentKey);
-        m_subObjectKeys.erase(_currentKey);
-        data.getContent().setKey(_newKey);
-        m_subObjectKeys.emplace(_newKey, data);
+        m_subObjects.at(pos).getContent().setRegisteredKey(_newKey);
+        if (m_keyIndex)
+            buildKeyIndex();
     }
-
 }
 
 /// vector<element> erase method with `replace()` function
 void DataObject::removeKey(std::string const& _key)
 {
     _assert(type() == DataType::Object, "type() == DataType::Object");
-    for (std::vector<spDataObject>::const_iterator it = m_subObjects.begin();
-         it != m_subObjects.end(); it++)
+    size_t const pos = findKeyPos(_key);
+    if (pos != c_noPos)
     {
-        if ((*it)->getKey() == _key)
-        {
-            setOverwrite(true);
-            m_subObjects.erase(it);
-            m_subObjectKeys.erase(_key);
-            setOverwrite(false);
-            break;
-        }
+        setOverwrite(true);
+        m_subObjects.erase(m_subObjects.begin() + pos);
+        setOverwrite(false);
+        if (m_keyIndex)
+            buildKeyIndex();
     }
 
     /*
@@ -318,10 +480,19 @@ void DataObject::removeKey(std::string const& _key)
 void DataObject::clear(DataType _type)
 {
     m_intVal = 0;
-    m_strKey = "";
+    setKey(string());
     m_strVal = "";
     m_subObjects.clear();
-    m_subObjectKeys.clear();
+    m_keyIndex.reset();
+    m_keyIndexDirty.store(false, std::memory_order_relaxed);
+    m_type = _type;
+}
+
+void DataObject::clearSubobjects(DataType _type)
+{
+    m_subObjects.clear();
+    m_keyIndex.reset();
+    m_keyIndexDirty.store(false, std::memory_order_relaxed);
     m_type = _type;
 }
 
@@ -338,6 +509,7 @@ void DataObject::performModifier(void (*f)(DataObject&), ModifierOption _opt, st
         f(*this);
         if (_opt == ModifierOption::RECURSIVE)
         {
+            // Subobjects renamed by the modifier are still found by their old keys
             for (auto& el : m_subObjects)
                 el.getContent().performModifier(f, _opt, _exceptionKeys);
         }
@@ -356,148 +528,117 @@ std::string DataObject::asJsonNoFirstKey() const
     return asJson(0, true, true);
 }
 
+namespace
+{
+void writeIndent(DataObjectSink& _out, int _level)
+{
+    static string const spaces(64, ' ');
+    size_t left = size_t(_level) * 4;
+    while (left > 0)
+    {
+        size_t const part = std::min(left, spaces.size());
+        _out.write(spaces.data(), part);
+        left -= part;
+    }
+}
+
+// Strings are printed as stored, only new lines and tabs are escaped
+void writeEscaped(DataObjectSink& _out, string const& _str)
+{
+    size_t begin = 0;
+    for (size_t i = 0; i < _str.size(); i++)
+    {
+        char const ch = _str[i];
+        if (ch != 10 && ch != 9)
+            continue;
+        _out.write(_str.data() + begin, i - begin);
+        _out.write(ch == 10 ? "\\n" : "\\t", 2);
+        begin = i + 1;
+    }
+    _out.write(_str.data() + begin, _str.size() - begin);
+}
+}  // namespace
+
 std::string DataObject::asJson(int level, bool pretty, bool nokey) const
 {
-    std::ostringstream out;
-    auto printLevel = [level, pretty, &out]() -> void {
-        if (pretty)
-            for (int i = 0; i < level * 4; i++)
-                out << " ";
-    };
+    string out;
+    StringSink sink(out);
+    writeJson(sink, level, pretty, nokey);
+    return out;
+}
 
-    auto printElements = [this, &out, level, pretty]() -> void {
-        for (std::vector<spDataObject>::const_iterator it = this->m_subObjects.begin();
-             it < this->m_subObjects.end(); it++)
-        {
-            out << (*it)->asJson(level + 1, pretty);
-            if (it + 1 != this->m_subObjects.end())
-                out << ",";
-            if (pretty)
-                out << std::endl;
-        }
-    };
+void DataObject::writeJson(DataObjectSink& _out, int level, bool pretty, bool nokey, bool sortKeys) const
+{
+    if (pretty)
+        writeIndent(_out, level);
+    if (!m_strKey.empty() && !nokey)
+    {
+        _out.write("\"", 1);
+        _out.write(m_strKey);
+        if (pretty)
+            _out.write("\" : ", 4);
+        else
+            _out.write("\":", 2);
+    }
 
-    string buffer;
     switch (m_type)
     {
     case DataType::NotInitialized:
-        printLevel();
-        if (!m_strKey.empty() && !nokey)
-        {
-            if (pretty)
-                out << "\"" << m_strKey << "\" : ";
-            else
-                out << "\"" << m_strKey << "\":";
-        }
-        out << "notinit";
+        _out.write("notinit", 7);
         break;
     case DataType::Null:
-        printLevel();
-        if (!m_strKey.empty() && !nokey)
-        {
-            if (pretty)
-                out << "\"" << m_strKey << "\" : ";
-            else
-                out << "\"" << m_strKey << "\":";
-        }
-        out << "null";
-        //out << "{}";  // why???
+        _out.write("null", 4);
         break;
     case DataType::Object:
-        if (!m_strKey.empty() && !nokey)
-        {
-            printLevel();
-            if (pretty)
-                out << "\"" << m_strKey << "\" : {" << std::endl;
-            else
-                out << "\"" << m_strKey << "\":{";
-        }
-        else
-        {
-            printLevel();
-            out << "{";
-            if (pretty)
-                out << std::endl;
-        }
-        printElements();
-        printLevel();
-        out << "}";
-        break;
     case DataType::Array:
-        if (!m_strKey.empty() && !nokey)
+    {
+        bool const isObject = m_type == DataType::Object;
+        _out.write(isObject ? "{" : "[", 1);
+        if (pretty)
+            _out.write("\n", 1);
+        // Object keys are printed in order without changing the object
+        std::vector<DataObject const*> sorted;
+        if (sortKeys && isObject)
         {
-            printLevel();
-            if (pretty)
-                out << "\"" << m_strKey << "\" : [" << std::endl;
-            else
-                out << "\"" << m_strKey << "\":[";
+            sorted.reserve(m_subObjects.size());
+            for (auto const& el : m_subObjects)
+                sorted.push_back(&el.getCContent());
+            std::stable_sort(sorted.begin(), sorted.end(),
+                [](DataObject const* _a, DataObject const* _b) { return _a->getKey() < _b->getKey(); });
         }
-        else
+
+        for (size_t i = 0; i < m_subObjects.size(); i++)
         {
-            printLevel();
-            out << "[";
+            DataObject const& el = sorted.empty() ? m_subObjects.at(i).getCContent() : *sorted.at(i);
+            el.writeJson(_out, level + 1, pretty, false, sortKeys);
+            if (i + 1 != m_subObjects.size())
+                _out.write(",", 1);
             if (pretty)
-                out << std::endl;
+                _out.write("\n", 1);
         }
-        printElements();
-        printLevel();
-        out << "]";
+        if (pretty)
+            writeIndent(_out, level);
+        _out.write(isObject ? "}" : "]", 1);
         break;
+    }
     case DataType::String:
-        printLevel();
-        if (pretty)
-        {
-            if (!m_strKey.empty() && !nokey)
-                out << "\"" << m_strKey << "\" : ";
-        }
-        else
-        {
-            if (!m_strKey.empty() && !nokey)
-                out << "\"" << m_strKey << "\":";
-        }
-
-        //  threat special chars
-        for (auto const& ch: m_strVal)
-        {
-            if (ch == 10)
-                buffer += "\\n";
-            else if (ch == 9)
-                buffer += "\\t";
-            else
-                buffer += ch;
-        }
-        out << "\"" << buffer << "\"";
+        _out.write("\"", 1);
+        writeEscaped(_out, m_strVal);
+        _out.write("\"", 1);
         break;
     case DataType::Integer:
-        printLevel();
-        if (!m_strKey.empty() && !nokey)
-        {
-            if (pretty)
-                out << "\"" << m_strKey << "\" : ";
-            else
-                out << "\"" << m_strKey << "\":";
-        }
-        out << m_intVal;
+        _out.write(std::to_string(m_intVal));
         break;
     case DataType::Bool:
-        printLevel();
-        if (!m_strKey.empty() && !nokey)
-        {
-            if (pretty)
-                out << "\"" << m_strKey << "\" : ";
-            else
-                out << "\"" << m_strKey << "\":";
-        }
         if (m_boolVal)
-            out << "true";
+            _out.write("true", 4);
         else
-            out << "false";
+            _out.write("false", 5);
         break;
     default:
-        out << "unknown " << dataTypeAsString(m_type) << std::endl;
+        _out.write("unknown " + dataTypeAsString(m_type) + "\n");
         break;
     }
-    return out.str();
 }
 
 std::string DataObject::dataTypeAsString(DataType _type)
@@ -594,7 +735,7 @@ DataObject& DataObject::_addSubObject(spDataObject const& _obj, string const& _k
     {
         m_subObjects.push_back(_obj);
         pos = m_subObjects.size() - 1;
-        setSubObjectKey(pos, key);
+        m_subObjects.at(pos).getContent().setRegisteredKey(key);
         m_subObjects.at(pos).getContent().setOverwrite(m_allowOverwrite);
         m_subObjects.at(pos).getContent().setAutosort(m_autosort);
     }
@@ -611,15 +752,89 @@ DataObject& DataObject::_addSubObject(spDataObject const& _obj, string const& _k
             m_subObjects.insert(m_subObjects.begin() + pos, 1, _obj);
             setOverwrite(false);
         }
-        m_subObjects.at(pos).getContent().setKey(key);
+        m_subObjects.at(pos).getContent().setRegisteredKey(key);
         m_subObjects.at(pos).getContent().setOverwrite(true);
         m_subObjects.at(pos).getContent().setAutosort(m_autosort);
     }
-    if (!key.empty())
-        m_subObjectKeys.emplace(key, m_subObjects.at(pos));
+
+    if (m_keyIndex && !m_keyIndexDirty.load(std::memory_order_relaxed) && pos == m_subObjects.size() - 1)
+        indexKey(pos);
+    else if (m_keyIndex || m_subObjects.size() > c_keyIndexThreshold)
+        buildKeyIndex();
     return m_subObjects.at(pos).getContent();
 }
 
+size_t DataObject::findKeyPos(std::string const& _key) const
+{
+    if (m_keyIndexDirty.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(g_keyIndexMutex);
+        if (m_keyIndexDirty.load(std::memory_order_relaxed))
+            buildKeyIndex();
+    }
+
+    if (!m_keyIndex)
+    {
+        for (size_t i = 0; i < m_subObjects.size(); i++)
+            if (m_subObjects.at(i)->lookupKey() == _key)
+                return i;
+        return c_noPos;
+    }
+
+    std::vector<DataObjectKeyIndex::Slot> const& slots = m_keyIndex->slots;
+    size_t const hash = std::hash<std::string>()(_key);
+    size_t const mask = slots.size() - 1;
+    for (size_t i = hash & mask; slots.at(i).pos != c_noPos; i = (i + 1) & mask)
+    {
+        DataObjectKeyIndex::Slot const& slot = slots.at(i);
+        if (slot.hash == hash && m_subObjects.at(slot.pos)->lookupKey() == _key)
+            return slot.pos;
+    }
+    return c_noPos;
+}
+
+void DataObject::buildKeyIndex() const
+{
+    if (m_subObjects.size() <= c_keyIndexThreshold)
+        m_keyIndex.reset();
+    else
+    {
+        size_t capacity = 64;
+        while (capacity < m_subObjects.size() * 4)
+            capacity *= 2;
+        if (!m_keyIndex)
+            m_keyIndex.reset(new DataObjectKeyIndex());
+        m_keyIndex->slots.assign(capacity, DataObjectKeyIndex::Slot{0, c_noPos});
+        m_keyIndex->used = 0;
+        for (size_t i = 0; i < m_subObjects.size(); i++)
+            indexKey(i);
+    }
+
+    // Lookups of other threads read the index once it is clean
+    m_keyIndexDirty.store(false, std::memory_order_release);
+}
+
+void DataObject::indexKey(size_t _pos) const
+{
+    std::vector<DataObjectKeyIndex::Slot>& slots = m_keyIndex->slots;
+    if ((m_keyIndex->used + 1) * 2 > slots.size())
+    {
+        buildKeyIndex();
+        return;
+    }
+
+    // The first subobject with the key is found, as with the linear scan
+    string const& key = m_subObjects.at(_pos)->lookupKey();
+    size_t const hash = std::hash<std::string>()(key);
+    size_t const mask = slots.size() - 1;
+    size_t i = hash & mask;
+    for (; slots.at(i).pos != c_noPos; i = (i + 1) & mask)
+        if (slots.at(i).hash == hash && m_subObjects.at(slots.at(i).pos)->lookupKey() == key)
+            return;
+    slots.at(i) = DataObjectKeyIndex::Slot{hash, _pos};
+    m_keyIndex->used++;
+}
+
 void DataObject::_assert(bool _flag, std::string const& _comment) const
 {
     if (!_flag)
@@ -634,6 +849,12 @@ void DataObject::_assert(bool _flag, std::string const& _comment) const
     }
 }
 
+void DataObject::_assert(bool _flag, char const* _comment) const
+{
+    if (!_flag)
+        _assert(_flag, std::string(_comment));
+}
+
 void DataObject::setString(string const& _value)
 {
     _assert(m_type == DataType::String || m_type == DataType::NotInitialized,
@@ -663,7 +884,7 @@ void DataObject::copyFrom(DataObject const& _other)
     clear();
     m_type = _other.type();
     if (!_other.getKey().empty())
-        m_strKey = _other.getKey();
+        setKey(_other.getKey());
 
     switch (m_type)
     {
@@ -812,8 +1033,9 @@ DataObject& DataObject::operator[](std::string const& _key)
     _assert(m_type == DataType::NotInitialized || m_type == DataType::Object,
         "m_type == DataType::NotInitialized || m_type == DataType::Object (DataObject& operator[])");
 
-    if (m_subObjectKeys.count(_key))
-        return m_subObjectKeys.at(_key).getContent();
+    size_t const pos = findKeyPos(_key);
+    if (pos != c_noPos)
+        return m_subObjects.at(pos).getContent();
 
     spDataObject newObj(new DataObject(DataType::NotInitialized));
     newObj.getContent().setKey(_key);
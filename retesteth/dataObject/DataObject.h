@@ -1,6 +1,7 @@
 #pragma once
 #include <dataObject/Exception.h>
 #include <dataObject/SPointer.h>
+#include <atomic>
 #include <memory>
 #include <set>
 #include <vector>
@@ -20,9 +21,42 @@ enum DataType
 };
 
 class DataObjectK;
+class DataObjectArena;
+struct DataObjectKeyIndex;
 class GCP_SPointerDataObject;
 typedef GCP_SPointerDataObject spDataObject;
 
+/// Output of DataObject::writeJson (string, file, hash function), see JsonWriter.h
+class DataObjectSink
+{
+public:
+    virtual ~DataObjectSink() {}
+    virtual void write(char const* _data, size_t _size) = 0;
+    void write(std::string const& _str) { write(_str.data(), _str.size()); }
+};
+
+/// Arena for the nodes of one test file document, opened by the file readers
+/// While the scope is open, DataObject nodes created on this thread are taken from the arena slabs
+/// The slabs are freed at once when the scope is closed and the last node of the arena is deleted
+/// Memory of deleted nodes is not reused and a node that outlives the document keeps all the slabs,
+/// so short lived documents (rpc responses, tool outputs) are allocated on the heap
+class DataObjectArenaScope
+{
+public:
+    DataObjectArenaScope();
+    ~DataObjectArenaScope();
+    DataObjectArenaScope(DataObjectArenaScope const&) = delete;
+    DataObjectArenaScope& operator=(DataObjectArenaScope const&) = delete;
+
+    size_t nodes() const;  // nodes allocated in the arena
+    size_t slabs() const;  // heap allocations of the arena
+    static bool isOpen();  // an arena scope is open on this thread
+
+private:
+    DataObjectArena* m_arena;
+    DataObjectArena* m_previous;
+};
+
 /// DataObject
 /// A data sturcture to manage data from json, yml
 class DataObject : public GCP_SPointerBase
@@ -36,6 +70,11 @@ public:
     DataObject(std::string const& _key, std::string const& _str);
     DataObject(std::string const& _key, int _val);
     DataObject(int _int);
+    ~DataObject();
+
+    // Nodes are allocated from the arena of the thread if a DataObjectArenaScope is open
+    static void* operator new(size_t _size);
+    static void operator delete(void* _ptr);
 
     DataType type() const;
     void setKey(std::string const& _key);
@@ -43,7 +82,6 @@ public:
     std::string& getKeyUnsafe();
 
     std::vector<spDataObject> const& getSubObjects() const;
-    std::map<string, spDataObject> const& getSubObjectKeys() const;
     std::vector<spDataObject>& getSubObjectsUnsafe();
 
     void addArrayObject(spDataObject const& _obj);
@@ -101,37 +139,49 @@ public:
 
     std::string asJsonNoFirstKey() const;
     std::string asJson(int level = 0, bool pretty = true, bool nokey = false) const;
+    // Print the same json as asJson into _out without building the string
+    // With sortKeys the keys of objects are printed in order, the object is not changed
+    void writeJson(
+        DataObjectSink& _out, int level = 0, bool pretty = true, bool nokey = false, bool sortKeys = false) const;
     static std::string dataTypeAsString(DataType _type);
 
     void setOverwrite(bool _overwrite) { m_allowOverwrite = _overwrite; }
     void setAutosort(bool _sort) { m_autosort = _sort; m_allowOverwrite = true; }
     bool isOverwritable() const { return m_allowOverwrite; }
     bool isAutosort() const { return m_autosort; }
-    void clearSubobjects(DataType _type = DataType::NotInitialized)
-    {
-        m_subObjects.clear();
-        m_subObjectKeys.clear();
-        m_type = _type;
-    }
+    void clearSubobjects(DataType _type = DataType::NotInitialized);
 
 private:
 
     DataObject& _addSubObject(spDataObject const& _obj, string const& _keyOverwrite = string());
     void _assert(bool _flag, std::string const& _comment = "") const;
+    void _assert(bool _flag, char const* _comment) const;  // no string is built if the assert holds
+
+    // Children are found by key with a scan of small objects and with m_keyIndex for big objects
+    // getSubObjectsUnsafe() marks the index dirty, it is built again on the next lookup (const too)
+    size_t findKeyPos(std::string const& _key) const;
+    void buildKeyIndex() const;
+    void indexKey(size_t _pos) const;
+
+    // Key the parent finds this node by, the key before an in-place rename if the node was renamed
+    std::string const& lookupKey() const { return m_lookupKey ? *m_lookupKey : m_strKey; }
+    void keepLookupKey();
+    void setRegisteredKey(std::string const& _key);
 
     // Use vector here to be able to quickly find insert position
     // of objects to be ordered by it's key with findOrderedKeyPosition
     std::vector<spDataObject> m_subObjects;
-    std::map<string, spDataObject> m_subObjectKeys;
+    mutable std::unique_ptr<DataObjectKeyIndex> m_keyIndex;
+    mutable std::atomic<bool> m_keyIndexDirty{false};
 
-    DataType m_type;
     std::string m_strKey;
-    bool m_allowOverwrite = false;  // allow overwrite elements
-    bool m_autosort = false;
-
+    std::unique_ptr<std::string> m_lookupKey;  // set when the node is renamed in place
     std::string m_strVal;
-    bool m_boolVal;
+    DataType m_type;
     int m_intVal;
+    bool m_boolVal;
+    bool m_allowOverwrite = false;  // allow overwrite elements
+    bool m_autosort = false;
 
     void (*m_verifier)(DataObject&) = 0;
 };
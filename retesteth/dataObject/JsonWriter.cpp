@@ -0,0 +1,94 @@
+#include <dataObject/JsonWriter.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dataobject
+{
+namespace
+{
+size_t const c_fileBufferSize = 64 * 1024;
+
+string errnoMessage(string const& _what)
+{
+    return _what + ": " + std::strerror(errno);
+}
+
+// Write all bytes, retrying partial writes and interrupts
+void writeAll(int _fd, char const* _data, size_t _size)
+{
+    while (_size > 0)
+    {
+        ssize_t const written = ::write(_fd, _data, _size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw DataObjectException() << errnoMessage("FileDescriptorSink could not write");
+        }
+        _data += written;
+        _size -= written;
+    }
+}
+}  // namespace
+
+FileDescriptorSink::FileDescriptorSink(int _fd) : m_fd(_fd), m_buffer(c_fileBufferSize) {}
+
+FileDescriptorSink::~FileDescriptorSink()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+    }
+}
+
+void FileDescriptorSink::write(char const* _data, size_t _size)
+{
+    if (m_used + _size > m_buffer.size())
+    {
+        flush();
+        // Large pieces (long strings) go directly to the file
+        if (_size >= m_buffer.size())
+        {
+            writeAll(m_fd, _data, _size);
+            return;
+        }
+    }
+    std::memcpy(m_buffer.data() + m_used, _data, _size);
+    m_used += _size;
+}
+
+void FileDescriptorSink::flush()
+{
+    size_t const used = m_used;
+    m_used = 0;
+    writeAll(m_fd, m_buffer.data(), used);
+}
+
+void writeJsonFile(std::string const& _file, DataObject const& _data, bool _pretty, bool _sortKeys)
+{
+    // Owner read and write only, as dev::writeFile does. An existing file gets the same mode
+    int const fd = ::open(_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        throw DataObjectException() << errnoMessage("writeJsonFile could not open `" + _file + "`");
+    (void)::fchmod(fd, S_IRUSR | S_IWUSR);
+    try
+    {
+        FileDescriptorSink sink(fd);
+        _data.writeJson(sink, 0, _pretty, false, _sortKeys);
+        sink.flush();
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0)
+        throw DataObjectException() << errnoMessage("writeJsonFile could not close `" + _file + "`");
+}
+}
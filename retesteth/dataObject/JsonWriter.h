@@ -0,0 +1,53 @@
+#pragma once
+#include <dataObject/DataObject.h>
+#include <ostream>
+
+// Outputs for DataObject::writeJson
+namespace dataobject
+{
+/// Appends the json to a string
+class StringSink : public DataObjectSink
+{
+public:
+    StringSink(std::string& _out) : m_out(_out) {}
+    void write(char const* _data, size_t _size) override { m_out.append(_data, _size); }
+
+private:
+    std::string& m_out;
+};
+
+/// Writes the json into std::ostream
+class StreamSink : public DataObjectSink
+{
+public:
+    StreamSink(std::ostream& _out) : m_out(_out) {}
+    void write(char const* _data, size_t _size) override { m_out.write(_data, _size); }
+
+private:
+    std::ostream& m_out;
+};
+
+/// Writes the json into a file descriptor through a fixed size buffer
+/// Memory use does not depend on the size of the json
+/// Throws DataObjectException if the data could not be written
+class FileDescriptorSink : public DataObjectSink
+{
+public:
+    FileDescriptorSink(int _fd);
+    ~FileDescriptorSink();  // flushes the buffer ignoring errors, call flush() to check them
+    FileDescriptorSink(FileDescriptorSink const&) = delete;
+    FileDescriptorSink& operator=(FileDescriptorSink const&) = delete;
+
+    void write(char const* _data, size_t _size) override;
+    void flush();
+
+private:
+    int m_fd;
+    std::vector<char> m_buffer;
+    size_t m_used = 0;
+};
+
+/// Print _data as json into _file, the file is created or truncated
+/// Throws DataObjectException if the file could not be written
+void writeJsonFile(std::string const& _file, DataObject const& _data, bool _pretty = true, bool _sortKeys = false);
+}
@@ -1,7 +1,7 @@
 #pragma once
+#include <atomic>
 #include <exception>
 #include <string>
-#include <mutex>
 
 namespace dataobject
 {
@@ -26,23 +26,29 @@ private:
 };
 
 void throwException(std::string const& _ex);
-void disableThreadsafe();
 
 template <class T>
 class GCP_SPointer;
 class GCP_SPointerBase
 {
 private:
-    int _nRef;
+    // Lock free reference counter, pointers are copied between the test threads
+    std::atomic<int> _nRef;
     bool _isEmpty;
-    void AddRef();
-    int DelRef();
-    int GetRef();
-    static std::mutex g_spRefAccessMutex;
-
+    void AddRef() { _nRef.fetch_add(1, std::memory_order_relaxed); }
+    int DelRef() { return _nRef.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+    int GetRef() const { return _nRef.load(std::memory_order_acquire); }
 
 public:
     GCP_SPointerBase() : _nRef(0), _isEmpty(false) {}
+
+    // A copy of the object is not referenced by the pointers of the original
+    GCP_SPointerBase(GCP_SPointerBase const& _other) : _nRef(0), _isEmpty(_other._isEmpty) {}
+    GCP_SPointerBase& operator=(GCP_SPointerBase const& _other)
+    {
+        _isEmpty = _other._isEmpty;
+        return *this;
+    }
     template <class T>
     friend class GCP_SPointer;
 };
@@ -71,7 +77,6 @@ private:
     }
 
 public:
-    static void DISABLETHREADSAFE() { disableThreadsafe(); };
     explicit GCP_SPointer() : _pointee(nullptr) {}
     GCP_SPointer(int) : _pointee(nullptr) {}
     explicit GCP_SPointer(T* pointee)
@@ -98,6 +103,9 @@ public:
         }
     }
 
+    // Take the reference of a temporary without touching the counter
+    GCP_SPointer(GCP_SPointer&& pnt) noexcept : _pointee(pnt._pointee) { pnt._pointee = nullptr; }
+
     T* pointee() { return _pointee; }
 
     // Remove link to the pointer.
@@ -119,6 +127,23 @@ public:
         return *this;
     }
 
+    GCP_SPointer& operator=(GCP_SPointer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            // Same pointee: keep our reference and drop the one of rhs
+            if (_pointee == rhs._pointee)
+                rhs.release();
+            else
+            {
+                release();
+                _pointee = rhs._pointee;
+            }
+            rhs._pointee = nullptr;
+        }
+        return *this;
+    }
+
     // Disable this to aboid auto cast confusion
     /*GCP_SPointer& operator=(const int rhs)
     {
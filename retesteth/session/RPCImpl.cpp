@@ -6,12 +6,45 @@
 #include <retesteth/ExitHandler.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/session/RPCImpl.h>
+#include <retesteth/session/RangePage.h>
 #include <retesteth/session/Session.h>
 #include <retesteth/testStructures/Common.h>
+#include <retesteth/testStructures/types/Ethereum/State.h>
 #include <retesteth/Options.h>
 
 using namespace test;
 
+namespace
+{
+// Max requests in one JSON-RPC batch, clients limit the batch size
+size_t const c_maxBatchSize = 100;
+
+// Calls that take the same time regardless of the test. The latency of the instance is measured on them,
+// so slow test requests (block import, state dump) do not trigger the recycle of the instance
+bool isLatencyProbe(std::string const& _methodName)
+{
+    return _methodName == "eth_blockNumber" || _methodName == "web3_clientVersion";
+}
+
+spVALUE readNonceResponse(spDataObject& _response)
+{
+    (*_response).performModifier(mod_valueToCompactEvenHexPrefixed);
+    if (_response->type() == DataType::String)
+        return spVALUE(new VALUE(_response));
+    return spVALUE(new VALUE(_response->asInt()));
+}
+
+spBYTES readCodeResponse(spDataObject const& _response)
+{
+    if (_response->asString().empty())
+    {
+        ETH_WARNING_TEST("eth_getCode return `` empty string, correct to `0x` empty bytes ", 6);
+        return spBYTES(new BYTES(DataObject("0x")));
+    }
+    return spBYTES(new BYTES(_response));
+}
+}  // namespace
+
 spDataObject RPCImpl::web3_clientVersion()
 {
     return rpcCall("web3_clientVersion", {});
@@ -32,10 +65,7 @@ spVALUE RPCImpl::eth_getTransactionCount(FH20 const& _address, VALUE const& _blo
     try
     {
         spDataObject response = rpcCall("eth_getTransactionCount", {quote(_address.asString()), quote(_blockNumber.asString())});
-        (*response).performModifier(mod_valueToCompactEvenHexPrefixed);
-        if (response->type() == DataType::String)
-            return spVALUE(new VALUE(response));
-        return spVALUE(new VALUE(response->asInt()));
+        return readNonceResponse(response);
     }
     catch(std::exception const& _ex)
     {
@@ -68,12 +98,7 @@ EthGetBlockBy RPCImpl::eth_getBlockByNumber(VALUE const& _blockNumber, Request _
 spBYTES RPCImpl::eth_getCode(FH20 const& _address, VALUE const& _blockNumber)
 {
     spDataObject res = rpcCall("eth_getCode", {quote(_address.asString()), quote(_blockNumber.asString())});
-    if (res->asString().empty())
-    {
-        ETH_WARNING_TEST("eth_getCode return `` empty string, correct to `0x` empty bytes ", 6);
-        return spBYTES(new BYTES(DataObject("0x")));
-    }
-    return spBYTES(new BYTES(res));
+    return readCodeResponse(res);
 }
 
 spVALUE RPCImpl::eth_getBalance(FH20 const& _address, VALUE const& _blockNumber)
@@ -120,10 +145,88 @@ DebugVMTrace RPCImpl::debug_traceTransaction(FH32 const& _trHash)
 {
     (void)_trHash;
     ETH_FAIL_MESSAGE("RPCImpl::debug_traceTransaction is not implemented!");
-    static DebugVMTrace empty("", "", FH32::zero(), "");
+    static DebugVMTrace empty("", "", FH32::zero(), string());
     return empty;
 }
 
+std::vector<spAccountBase> RPCImpl::debug_getAccountsBatch(
+    VALUE const& _blockNumber, VALUE const& _txIndex, std::vector<FH20> const& _addresses, size_t _sizeLimit)
+{
+    // First batch reads account fields and the first storage page of every account
+    // Next batches read next storage pages of the accounts that have more storage
+    string const bNumber = quote(_blockNumber.asDecString());
+    string const bNumberHex = quote(_blockNumber.asString());
+    string const txIndex = _txIndex.asDecString();
+    RangePage page(20);
+    auto storageRequest = [this, &bNumber, &txIndex, &page](FH20 const& _address, FH32 const& _begin) {
+        return RPCRequest{"debug_storageRangeAt",
+            {bNumber, txIndex, quote(_address.asString()), quote(_begin.asString()), fto_string(page.size())}};
+    };
+
+    std::vector<RPCRequest> requests;
+    for (auto const& address : _addresses)
+    {
+        string const addr = quote(address.asString());
+        requests.push_back({"eth_getBalance", {addr, bNumberHex}});
+        requests.push_back({"eth_getTransactionCount", {addr, bNumberHex}});
+        requests.push_back({"eth_getCode", {addr, bNumberHex}});
+        requests.push_back(storageRequest(address, FH32::zero()));
+    }
+    dev::Timer timer;
+    std::vector<spDataObject> responses = rpcBatchCall(requests);
+
+    std::vector<spVALUE> balances;
+    std::vector<spVALUE> nonces;
+    std::vector<spBYTES> codes;
+    std::vector<spStorage> storages;
+    std::vector<std::pair<size_t, FH32>> pending;
+    size_t byteSize = 0;
+    for (size_t i = 0; i < _addresses.size(); i++)
+    {
+        balances.push_back(spVALUE(new VALUE(responses.at(i * 4))));
+        nonces.push_back(readNonceResponse(responses.at(i * 4 + 1)));
+        codes.push_back(readCodeResponse(responses.at(i * 4 + 2)));
+
+        DebugStorageRangeAt const range(responses.at(i * 4 + 3).getCContent());
+        storages.push_back(spStorage(new Storage(DataObject(DataType::Object))));
+        storages.back().getContent().merge(range.storage());
+        if (!range.nextKey().isZero())
+            pending.push_back({i, range.nextKey()});
+        byteSize += range.storage().getKeys().size() * 64 + codes.back()->asString().size() / 2;
+    }
+    page.update(!pending.empty(), timer.elapsed());
+
+    size_t safety = 500;
+    auto sizeLimitReached = [_sizeLimit, &byteSize]() { return _sizeLimit != 0 && byteSize > _sizeLimit; };
+    while (!pending.empty() && --safety && !sizeLimitReached())
+    {
+        requests.clear();
+        for (auto const& el : pending)
+            requests.push_back(storageRequest(_addresses.at(el.first), el.second));
+        timer.restart();
+        responses = rpcBatchCall(requests);
+
+        std::vector<std::pair<size_t, FH32>> nextPending;
+        for (size_t i = 0; i < pending.size(); i++)
+        {
+            DebugStorageRangeAt const range(responses.at(i).getCContent());
+            storages.at(pending.at(i).first).getContent().merge(range.storage());
+            if (!range.nextKey().isZero())
+                nextPending.push_back({pending.at(i).first, range.nextKey()});
+            byteSize += range.storage().getKeys().size() * 64;
+        }
+        pending = nextPending;
+        page.update(!pending.empty(), timer.elapsed());
+    }
+    if (safety == 0)
+        ETH_ERROR_MESSAGE("debug_getAccountsBatch::DebugStorageRangeAt seems like an endless loop!");
+
+    std::vector<spAccountBase> accounts;
+    for (size_t i = 0; i < _addresses.size(); i++)
+        accounts.push_back(spAccountBase(new State::Account(_addresses.at(i), balances.at(i), nonces.at(i), codes.at(i), storages.at(i))));
+    return accounts;
+}
+
 // Test
 void RPCImpl::test_setChainParams(spSetChainParamsArgs const& _config)
 {
@@ -202,6 +305,34 @@ VALUE RPCImpl::test_calculateDifficulty(FORK const& _fork, VALUE const& _blockNu
         );
 }
 
+std::vector<VALUE> RPCImpl::test_calculateDifficulty(FORK const& _fork, std::vector<CalculateDifficultyArgs> const& _args)
+{
+    std::vector<VALUE> results;
+    for (auto const& arg : _args)
+        results.push_back(test_calculateDifficulty(_fork, arg.blockNumber(), arg.parentTimestamp(),
+            arg.parentDifficulty(), arg.currentTimestamp(), arg.uncleNumber()));
+    return results;
+}
+
+std::vector<MineTransactionResult> RPCImpl::test_mineTransactionsBatch(
+    std::vector<spTransaction> const& _txs, VALUE const& _timestamp)
+{
+    // Client does not support batches, execute the transactions one by one
+    bool const checkLogsHash = Options::getDynamicOptions().getCurrentConfig().cfgFile().checkLogsHash();
+    std::vector<MineTransactionResult> results;
+    for (auto const& tr : _txs)
+    {
+        test_modifyTimestamp(_timestamp);
+        FH32 const trHash(eth_sendRawTransaction(tr->getRawBytes(), tr->getSecret()));
+        MineBlocksResult const mRes = test_mineBlocks(1);
+        EthGetBlockBy const blockInfo(eth_getBlockByNumber(eth_blockNumber(), Request::LESSOBJECTS));
+        FH32 const logHash = checkLogsHash ? test_getLogHash(trHash) : FH32::zero();
+        results.emplace_back(mRes, blockInfo, logHash);
+        test_rewindToBlock(0);
+    }
+    return results;
+}
+
 // Internal
 std::string RPCImpl::sendRawRequest(std::string const& _request)
 {
@@ -209,8 +340,7 @@ std::string RPCImpl::sendRawRequest(std::string const& _request)
     return m_socket.sendRequest(_request, validator);
 }
 
-spDataObject RPCImpl::rpcCall(
-    std::string const& _methodName, std::vector<std::string> const& _args, bool _canFail)
+string RPCImpl::makeRequest(std::string const& _methodName, std::vector<std::string> const& _args)
 {
     string request = "{\"jsonrpc\":\"2.0\",\"method\":\"" + _methodName + "\",\"params\":[";
     for (size_t i = 0; i < _args.size(); ++i)
@@ -221,19 +351,85 @@ spDataObject RPCImpl::rpcCall(
     }
 
     request += "],\"id\":" + to_string(m_rpcSequence++) + "}";
+    return request;
+}
 
+spDataObject RPCImpl::rpcCall(
+    std::string const& _methodName, std::vector<std::string> const& _args, bool _canFail)
+{
+    string const request = makeRequest(_methodName, _args);
     ETH_TEST_MESSAGE("Request: " + request);
     JsonObjectValidator validator;  // read response while counting `{}`
     string reply = m_socket.sendRequest(request, validator);
     ETH_TEST_MESSAGE("Reply: `" + reply + "`");
+    if (isLatencyProbe(_methodName))
+    {
+        double const seconds = m_socket.lastRequestTime();
+        m_averageLatency = m_averageLatency == 0 ? seconds : m_averageLatency * 0.9 + seconds * 0.1;
+    }
 
     spDataObject result = ConvertJsoncppStringToData(reply, string(), false);
+    return processReply(result, request, _canFail);
+}
+
+std::vector<spDataObject> RPCImpl::rpcBatchCall(std::vector<RPCRequest> const& _requests, bool _canFail)
+{
+    std::vector<spDataObject> results;
+    for (size_t begin = 0; begin < _requests.size(); begin += c_maxBatchSize)
+    {
+        size_t const end = std::min(begin + c_maxBatchSize, _requests.size());
+        if (m_batchSupported)
+        {
+            // Request ids of the batch are sequential, replies are matched by id as the order is not guaranteed
+            size_t const firstId = m_rpcSequence;
+            std::vector<string> requests;
+            string batch = "[";
+            for (size_t i = begin; i < end; i++)
+            {
+                requests.push_back(makeRequest(_requests.at(i).method, _requests.at(i).args));
+                batch += requests.back();
+                if (i + 1 != end)
+                    batch += ",";
+            }
+            batch += "]";
+
+            ETH_TEST_MESSAGE("Request: " + batch);
+            JsonObjectValidator validator;  // counts `[]` of the batch array too
+            string const reply = m_socket.sendRequest(batch, validator);
+            ETH_TEST_MESSAGE("Reply: `" + reply + "`");
+
+            spDataObject response = ConvertJsoncppStringToData(reply, string(), false);
+            if (response->type() == DataType::Array && response->getSubObjects().size() == requests.size())
+            {
+                std::vector<spDataObject> batchResults(requests.size(), spDataObject(0));
+                for (auto& el : (*response).getSubObjectsUnsafe())
+                {
+                    size_t const index = el->count("id") ? size_t(el->atKey("id").asInt()) - firstId : requests.size();
+                    if (index >= requests.size() || !batchResults.at(index).isEmpty())
+                        ETH_FAIL_MESSAGE("rpcBatchCall: unexpected reply id in batch response: " + el->asJson(0, false));
+                    batchResults.at(index) = processReply(el, requests.at(index), _canFail);
+                }
+                results.insert(results.end(), batchResults.begin(), batchResults.end());
+                continue;
+            }
+            ETH_WARNING("Client does not support JSON-RPC batch requests, using single requests instead");
+            m_batchSupported = false;
+        }
+
+        for (size_t i = begin; i < end; i++)
+            results.push_back(rpcCall(_requests.at(i).method, _requests.at(i).args, _canFail));
+    }
+    return results;
+}
+
+spDataObject RPCImpl::processReply(spDataObject& result, string const& _request, bool _canFail)
+{
     if (result->count("error"))
         (*result)["result"] = "";
 
     if (!ExitHandler::receivedExitSignal())
     {
-        REQUIRE_JSONFIELDS(result, "rpcCall_response (req: '" + request.substr(0, 70) + "')",
+        REQUIRE_JSONFIELDS(result, "rpcCall_response (req: '" + _request.substr(0, 70) + "')",
             {{"jsonrpc", {{DataType::String}, jsonField::Required}},
              {"id", {{DataType::Integer}, jsonField::Required}},
              {"result", {{DataType::String, DataType::Integer, DataType::Bool, DataType::Object, DataType::Array},
@@ -249,7 +445,7 @@ spDataObject RPCImpl::rpcCall(
     if (result->count("error"))
     {
         test::TestOutputHelper const& helper = test::TestOutputHelper::get();
-        string const message = "Error on JSON-RPC call (" + helper.testInfo().errorDebug() + "):\nRequest: '" + request + "'" +
+        string const message = "Error on JSON-RPC call (" + helper.testInfo().errorDebug() + "):\nRequest: '" + _request + "'" +
                                "\nResult: '" + (*result)["error"]["message"].asString() + "'\n";
         m_lastInterfaceError = RPCError((*result)["error"]["message"].asString(), message);
 
@@ -272,3 +468,8 @@ std::string const& RPCImpl::getSocketPath() const
 {
     return m_socket.path();
 }
+
+double RPCImpl::getAverageLatency() const
+{
+    return m_averageLatency;
+}
@@ -3,6 +3,13 @@
 #include <retesteth/session/Socket.h>
 #include <string>
 
+// Single request of the JSON-RPC batch
+struct RPCRequest
+{
+    std::string method;
+    std::vector<std::string> args;
+};
+
 class RPCImpl : public SessionInterface
 {
 public:
@@ -32,6 +39,8 @@ public:
     DebugStorageRangeAt debug_storageRangeAt(
         FH32 const& _blockHash, VALUE const& _txIndex, FH20 const& _address, FH32 const& _begin, int _maxResults) override;
     DebugVMTrace debug_traceTransaction(FH32 const& _trHash) override;
+    std::vector<spAccountBase> debug_getAccountsBatch(VALUE const& _blockNumber, VALUE const& _txIndex,
+        std::vector<FH20> const& _addresses, size_t _sizeLimit) override;
 
     // Test
     void test_setChainParams(spSetChainParamsArgs const& _config) override;
@@ -43,16 +52,29 @@ public:
     TestRawTransaction test_rawTransaction(BYTES const& _rlp, FORK const& _fork) override;
     VALUE test_calculateDifficulty(FORK const& _fork, VALUE const& _blockNumber, VALUE const& _parentTimestamp,
         VALUE const& _parentDifficulty, VALUE const& _currentTimestamp, VALUE const& _uncleNumber) override;
+    std::vector<VALUE> test_calculateDifficulty(FORK const& _fork, std::vector<CalculateDifficultyArgs> const& _args) override;
+    std::vector<MineTransactionResult> test_mineTransactionsBatch(
+        std::vector<spTransaction> const& _txs, VALUE const& _timestamp) override;
 
     // Internal
     std::string sendRawRequest(std::string const& _request);
     spDataObject rpcCall(std::string const& _methodName,
         std::vector<std::string> const& _args = std::vector<std::string>(),
         bool _canFail = false) override;
+
+    // Send the requests as JSON-RPC batch arrays, results are returned in the order of requests
+    // Falls back to single calls if the client does not support batches
+    std::vector<spDataObject> rpcBatchCall(std::vector<RPCRequest> const& _requests, bool _canFail = false);
     Socket::SocketType getSocketType() const override;
     std::string const& getSocketPath() const override;
+    double getAverageLatency() const override;
 
 private:
+    std::string makeRequest(std::string const& _methodName, std::vector<std::string> const& _args);
+    spDataObject processReply(spDataObject& _reply, std::string const& _request, bool _canFail);
+
     Socket m_socket;
     size_t m_rpcSequence = 1;
+    bool m_batchSupported = true;
+    double m_averageLatency = 0;  // Moving average of the lightweight calls in seconds
 };
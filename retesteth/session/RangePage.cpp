@@ -0,0 +1,33 @@
+#include "RangePage.h"
+#include <retesteth/Options.h>
+#include <algorithm>
+#include <climits>
+
+using namespace test;
+
+namespace
+{
+// Grow the page while the client answers faster than this, shrink when slower
+double const c_fastResponse = 0.5;
+double const c_slowResponse = 2;
+size_t const c_growFactor = 4;
+}  // namespace
+
+RangePage::RangePage(size_t _initialSize)
+{
+    // Range requests take the page size as int
+    size_t const maxPage = Options::getCurrentConfig().cfgFile().maxRangePage();
+    m_maxSize = maxPage == 0 ? INT_MAX : maxPage;
+    m_minSize = std::min(_initialSize, m_maxSize);
+    m_size = maxPage == 0 ? m_maxSize : m_minSize;
+}
+
+void RangePage::update(bool _full, double _seconds)
+{
+    if (!_full)
+        return;
+    if (_seconds < c_fastResponse)
+        m_size = std::min(m_size * c_growFactor, m_maxSize);
+    else if (_seconds > c_slowResponse)
+        m_size = std::max(m_size / 2, m_minSize);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <stddef.h>
+
+// Page size of debug_accountRange and debug_storageRangeAt requests
+// Starts with the initial size and grows while the pages are full and the client answers fast,
+// up to `maxRangePage` of the client config. With `unlimited` the whole range is asked at once
+class RangePage
+{
+public:
+    RangePage(size_t _initialSize);
+    size_t size() const { return m_size; }
+
+    // Adjust the page after a request that took _seconds. _full if the client has more records
+    void update(bool _full, double _seconds);
+
+private:
+    size_t m_size;
+    size_t m_minSize;
+    size_t m_maxSize;
+};
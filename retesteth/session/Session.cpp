@@ -22,7 +22,15 @@
 
 #include "Session.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <set>
+#include <sstream>
 #include <thread>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <retesteth/EthChecks.h>
 #include <retesteth/Options.h>
 #include <retesteth/TestHelper.h>
@@ -46,6 +54,8 @@ struct sessionInfo
         isUsed = RPCSession::NotExist;
         configId = _configId;
         totalRuns = 0;
+        lastSample = std::chrono::steady_clock::now();
+        cpuTicks = 0;
     }
     std::unique_ptr<RPCSession> session;
     std::unique_ptr<FILE> filePipe;
@@ -54,51 +64,288 @@ struct sessionInfo
     std::string tmpDir;
     test::ClientConfigID configId;
     size_t totalRuns;
+    std::chrono::steady_clock::time_point lastSample;  // Last check of the instance resources
+    size_t cpuTicks;                                   // CPU time of the instance at lastSample
 };
 
-void closeSession(thread::id const& _threadID);
+// Sessions of a thread are kept per client config, a worker could run tests of several configs
+typedef std::pair<thread::id, unsigned> SessionKey;
+SessionKey sessionKey(thread::id const& _threadID)
+{
+    return SessionKey(_threadID, Options::getDynamicOptions().getCurrentConfig().getId().id());
+}
+
+void closeSession(SessionKey const& _key);
+void closeSessionInfo(sessionInfo& _info);
 
 std::mutex g_socketMapMutex;
-static std::map<thread::id, sessionInfo> socketMap;
+static std::map<SessionKey, sessionInfo> socketMap;
 
-void RPCSession::runNewInstanceOfAClient(thread::id const& _threadID, ClientConfig const& _config)
+// Number of sessions opened for the config. g_socketMapMutex must be locked
+size_t configSessions(test::ClientConfigID const& _configId)
 {
-    switch (_config.cfgFile().socketType())
+    size_t sessions = 0;
+    for (auto const& socket : socketMap)
+        if (socket.second.configId == _configId)
+            sessions++;
+    return sessions;
+}
+
+// Clients are restarted (flushed) after this number of test runs
+size_t const c_maxTestBeforeFlush = 1500;
+
+// Replacement instances of ipc clients are started in background before the flush
+// The flush then swaps the sessions and closes the old instances in background
+size_t const c_prewarmBeforeFlush = 1200;
+std::mutex g_warmSessionsMutex;
+std::vector<sessionInfo> g_warmSessions;
+
+// Exhausted instance (pipePid) and its replacement, prewarmed in background. The worker that uses
+// the instance swaps it with the replacement between tests. One instance is recycled at a time
+// Guarded by g_warmSessionsMutex
+int g_recyclePid = 0;
+std::unique_ptr<sessionInfo> g_recycleReplacement;
+
+// Instances are started and closed by detached threads, clearSessions waits until all of them finish
+// Guarded by g_warmSessionsMutex
+size_t g_backgroundTasks = 0;
+std::condition_variable g_backgroundTasksDone;
+
+// Run _task(_args...) in a detached thread. g_warmSessionsMutex must be locked
+template <class Task, class... Args>
+void startBackgroundTask(Task _task, Args&&... _args)
+{
+    g_backgroundTasks++;
+    std::thread(
+        [_task](typename std::decay<Args>::type... _taskArgs) {
+            struct TaskDone
+            {
+                ~TaskDone()
+                {
+                    std::lock_guard<std::mutex> lock(g_warmSessionsMutex);
+                    g_backgroundTasks--;
+                    g_backgroundTasksDone.notify_all();
+                }
+            } done;
+            _task(std::move(_taskArgs)...);
+        },
+        std::forward<Args>(_args)...)
+        .detach();
+}
+
+// Configs whose tcp start script has just run. The thread that ran it probes the clients
+// without g_socketMapMutex, other threads wait on g_clientsStarted before using the config
+std::set<unsigned> g_startingConfigs;
+std::condition_variable g_clientsStarted;
+
+// Ask the client web3_clientVersion with growing delay until it answers or the deadline
+bool waitForClient(Socket::SocketType _type, string const& _path, chrono::steady_clock::time_point const& _deadline)
+{
+    chrono::milliseconds delay(50);
+    while (!ExitHandler::receivedExitSignal())
     {
-    case ClientConfgSocketType::IPC:
+        if (Socket::probe(_type, _path, 1000))
+            return true;
+        if (chrono::steady_clock::now() + delay > _deadline)
+            return false;
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, chrono::milliseconds(1000));
+    }
+    return false;
+}
+
+// Wait until the tcp clients of the config answer after the start script, initializeTime is the upper limit
+void waitForStartedClients(ClientConfig const& _config)
+{
+    size_t const initTime = _config.cfgFile().initializeTime();
+    size_t const seconds = Options::get().lowcpu ? initTime * 5 : initTime;
+    auto const deadline = chrono::steady_clock::now() + chrono::seconds(seconds);
+    for (auto const& addr : _config.cfgFile().socketAdresses())
     {
-        fs::path tmpDir = test::createUniqueTmpDirectory();
-        string ipcPath = tmpDir.string() + "/geth.ipc";
+        if (!waitForClient(Socket::SocketType::TCP, addr.asString(), deadline))
+        {
+            ETH_WARNING("Client `" + addr.asString() + "` does not answer " + test::fto_string(seconds) +
+                        " seconds after the start script");
+            break;
+        }
+    }
+}
 
-        string command = "bash";
-        std::vector<string> args;
-        args.push_back(_config.getShellPath().c_str());
-        args.push_back(tmpDir.string());
-        args.push_back(ipcPath);
+// Resources of a client instance are checked not more often than this
+auto const c_sampleInterval = chrono::seconds(2);
 
-        int pid = 0;
-        test::popenOutput mode =
-            (Options::get().enableClientsOutput) ? test::popenOutput::EnableALL : test::popenOutput::DisableAll;
-        FILE* fp = test::popen2(command, args, "r", pid, mode);
-        if (!fp)
+// The process and all its child processes
+// The script started with popen2 runs the client as a child process
+// Children are read from /proc/<pid>/task/<tid>/children, so only the process tree is visited
+std::vector<int> processTree(int _pid)
+{
+    std::vector<int> tree;
+    std::vector<int> queue = {_pid};
+    while (!queue.empty())
+    {
+        int const pid = queue.back();
+        queue.pop_back();
+        tree.push_back(pid);
+        boost::system::error_code ec;
+        fs::path const tasks = fs::path("/proc") / test::fto_string(pid) / "task";
+        for (fs::directory_iterator it(tasks, ec), end; !ec && it != end; it.increment(ec))
         {
-            ETH_ERROR_MESSAGE("Failed to start the client: '" + command + "'");
-            std::raise(SIGABRT);
+            std::ifstream childrenFile((it->path() / "children").string());
+            int child = 0;
+            while (childrenFile >> child)
+                queue.push_back(child);
         }
-        else
+    }
+    return tree;
+}
+
+// Resident memory of the process tree in bytes
+size_t processTreeMemory(int _pid)
+{
+    size_t total = 0;
+    for (int const pid : processTree(_pid))
+    {
+        // size resident shared ... in pages
+        std::ifstream statmFile((fs::path("/proc") / test::fto_string(pid) / "statm").string());
+        size_t size = 0;
+        size_t resident = 0;
+        if (statmFile >> size >> resident)
+            total += resident * sysconf(_SC_PAGESIZE);
+    }
+    return total;
+}
+
+// User and system CPU time of the process tree in clock ticks
+size_t processTreeCpuTicks(int _pid)
+{
+    size_t total = 0;
+    for (int const pid : processTree(_pid))
+    {
+        // pid (comm) state ppid ... utime stime are the fields 14 and 15, comm might have spaces
+        std::ifstream statFile((fs::path("/proc") / test::fto_string(pid) / "stat").string());
+        string const stat((std::istreambuf_iterator<char>(statFile)), std::istreambuf_iterator<char>());
+        size_t const commEnd = stat.rfind(')');
+        if (commEnd == string::npos)
+            continue;
+        std::istringstream fields(stat.substr(commEnd + 1));
+        string field;
+        for (size_t i = 3; i < 14 && fields >> field; i++)
+            ;
+        size_t utime = 0;
+        size_t stime = 0;
+        if (fields >> utime >> stime)
+            total += utime + stime;
+    }
+    return total;
+}
+
+// Client processes get this time to exit after the kill signal
+auto const c_clientExitTimeout = chrono::seconds(10);
+
+// Wait until the processes of _tree have exited or the deadline. _tree.at(0) is the child process
+// started with popen2, it is reaped here. The rest are its children
+bool waitForProcessesExit(std::vector<int> const& _tree, chrono::steady_clock::time_point const& _deadline)
+{
+    chrono::milliseconds delay(10);
+    size_t next = 0;
+    while (true)
+    {
+        if (next == 0 && waitpid(_tree.at(0), NULL, WNOHANG) != 0)
+            next++;
+        while (next > 0 && next < _tree.size() && kill(_tree.at(next), 0) != 0 && errno == ESRCH)
+            next++;
+        if (next == _tree.size())
+            return true;
+        if (chrono::steady_clock::now() + delay > _deadline)
+            return false;
+        std::this_thread::sleep_for(delay);
+        delay = std::min(delay * 2, chrono::milliseconds(200));
+    }
+}
+
+// Instances of the config are restarted by memory and latency limits, not by the test count
+bool hasRecycleLimits(ClientConfig const& _config)
+{
+    return _config.cfgFile().recycleMemory() != 0 || _config.cfgFile().recycleLatency() != 0;
+}
+
+void retireSession(sessionInfo _info)
+{
+    closeSessionInfo(_info);
+}
+
+// Replace all sessions of the config with prewarmed instances, old instances are closed in background
+// Replaces nothing and returns false if there are not enough prewarmed instances
+bool replaceWithWarmSessions(test::ClientConfigID const& _configId)
+{
+    std::lock_guard<std::mutex> lock(g_socketMapMutex);
+    std::lock_guard<std::mutex> lockWarm(g_warmSessionsMutex);
+    std::vector<size_t> warm;
+    for (size_t i = 0; i < g_warmSessions.size(); i++)
+        if (g_warmSessions.at(i).configId == _configId)
+            warm.push_back(i);
+
+    size_t const sessions = configSessions(_configId);
+    if (sessions == 0 || warm.size() < sessions)
+        return false;
+
+    size_t next = 0;
+    for (auto& socket : socketMap)
+    {
+        sessionInfo& info = socket.second;
+        if (info.configId != _configId)
+            continue;
+        sessionInfo retired(std::move(info));
+        info = std::move(g_warmSessions.at(warm.at(next++)));
+        info.isUsed = retired.isUsed;
+        startBackgroundTask(retireSession, std::move(retired));
+    }
+    while (next-- > 0)
+        g_warmSessions.erase(g_warmSessions.begin() + warm.at(next));
+    ETH_LOG("Replaced " + test::fto_string(sessions) + " client sessions with prewarmed instances", 1);
+    return true;
+}
+
+// Move an idle session of the config to _threadID. g_socketMapMutex must be locked
+// Finished sessions of the other threads are idle too, their threads might run another config now
+bool assignAvailableSession(thread::id const& _threadID, test::ClientConfigID const& _configId)
+{
+    SessionKey const key(_threadID, _configId.id());
+    for (auto& socket : socketMap)
+    {
+        RPCSession::SessionStatus const status = socket.second.isUsed;
+        if (status == RPCSession::SessionStatus::Available || status == RPCSession::SessionStatus::HasFinished)
+            if (socket.second.configId == _configId)
+            {
+                socket.second.isUsed = RPCSession::SessionStatus::Working;
+                socketMap.insert(std::pair<SessionKey, sessionInfo>(key, std::move(socket.second)));
+                socketMap.erase(socketMap.find(socket.first));  // remove previous threadID assigment to this socket
+                assert(socketMap.count(key));
+                return true;
+            }
+    }
+    return false;
+}
+
+void RPCSession::runNewInstanceOfAClient(
+    thread::id const& _threadID, ClientConfig const& _config, std::unique_lock<std::mutex>& _lock)
+{
+    SessionKey const key(_threadID, _config.getId().id());
+    switch (_config.cfgFile().socketType())
+    {
+    case ClientConfgSocketType::IPC:
+    {
+        // Only this thread creates the session of its key, the instance is started without the lock
+        _lock.unlock();
+        std::unique_ptr<sessionInfo> info = startIPCInstance(_config);
+        _lock.lock();
+        if (info == nullptr)
         {
-            int maxSeconds = 25;
-            while (!boost::filesystem::exists(ipcPath) && maxSeconds-- > 0)
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-            ETH_FAIL_REQUIRE_MESSAGE(maxSeconds > 0, "Client took too long to start ipc!");
-            // Client has opened ipc socket. wait for it to initialize
-            ClientConfig const& curCFG = Options::getDynamicOptions().getCurrentConfig();
-            size_t const initTime = curCFG.cfgFile().initializeTime();
-            std::this_thread::sleep_for(std::chrono::seconds(initTime));
+            ETH_ERROR_MESSAGE("Failed to start the client or client took too long to start ipc: '" +
+                              _config.getShellPath().string() + "'");
+            std::raise(SIGABRT);
         }
-        sessionInfo info(
-            fp, new RPCSession(new RPCImpl(Socket::SocketType::IPC, ipcPath)), tmpDir.string(), pid, _config.getId());
-        socketMap.insert(std::pair<thread::id, sessionInfo>(_threadID, std::move(info)));
+        socketMap.insert(std::pair<SessionKey, sessionInfo>(key, std::move(*info)));
         break;
     }
     case ClientConfgSocketType::TCP:
@@ -107,14 +354,14 @@ void RPCSession::runNewInstanceOfAClient(thread::id const& _threadID, ClientConf
         std::vector<IPADDRESS> const& ports =
             (opt.nodesoverride.size() > 0 ? opt.nodesoverride : _config.cfgFile().socketAdresses());
 
-        // Create sessionInfo for a tcp address that is still not present in socketMap
+        // Create sessionInfo for a tcp address of the config that is still not present in socketMap
         for (auto const& addr : ports)
         {
             bool unused = true;
             for (auto const& socket : socketMap)
             {
                 sessionInfo const& sInfo = socket.second;
-                if (sInfo.session.get()->getImplementation().getSocketPath() == addr.asString())
+                if (sInfo.configId == _config.getId() && sInfo.session.get()->getImplementation().getSocketPath() == addr.asString())
                 {
                     unused = false;
                     break;
@@ -125,7 +372,7 @@ void RPCSession::runNewInstanceOfAClient(thread::id const& _threadID, ClientConf
                 sessionInfo info(
                     NULL, new RPCSession(new RPCImpl(Socket::SocketType::TCP, addr.asString())), "", 0, _config.getId());
                 ETH_LOG("addr: " + addr.asString(), 2);
-                socketMap.insert(std::pair<thread::id, sessionInfo>(_threadID, std::move(info)));
+                socketMap.insert(std::pair<SessionKey, sessionInfo>(key, std::move(info)));
                 return;
             }
         }
@@ -140,16 +387,17 @@ void RPCSession::runNewInstanceOfAClient(thread::id const& _threadID, ClientConf
         FILE* fp = NULL;
         sessionInfo info(
             fp, new RPCSession(new RPCImpl(Socket::SocketType::IPC, ipcPath.string())), tmpDir.string(), pid, _config.getId());
-        socketMap.insert(std::pair<thread::id, sessionInfo>(_threadID, std::move(info)));
+        socketMap.insert(std::pair<SessionKey, sessionInfo>(key, std::move(info)));
         break;
     }
 
     case ClientConfgSocketType::TransitionTool:
     {
         fs::path tmpDir = test::createUniqueTmpDirectory();
-        sessionInfo info(NULL, new RPCSession(new ToolImpl(Socket::SocketType::TCP, _config.cfgFile().shell(), tmpDir)),
+        ClientConfigFile const& cfg = _config.cfgFile();
+        sessionInfo info(NULL, new RPCSession(new ToolImpl(Socket::SocketType::TCP, cfg.shell(), tmpDir, cfg.toolMode())),
             tmpDir.string(), 0, _config.getId());
-        socketMap.insert(std::pair<thread::id, sessionInfo>(_threadID, std::move(info)));
+        socketMap.insert(std::pair<SessionKey, sessionInfo>(key, std::move(info)));
         break;
     }
     default:
@@ -157,6 +405,131 @@ void RPCSession::runNewInstanceOfAClient(thread::id const& _threadID, ClientConf
     }
 }
 
+std::unique_ptr<sessionInfo> RPCSession::startIPCInstance(ClientConfig const& _config)
+{
+    fs::path tmpDir = test::createUniqueTmpDirectory();
+    string ipcPath = tmpDir.string() + "/geth.ipc";
+
+    string command = "bash";
+    std::vector<string> args;
+    args.push_back(_config.getShellPath().c_str());
+    args.push_back(tmpDir.string());
+    args.push_back(ipcPath);
+
+    int pid = 0;
+    test::popenOutput mode =
+        (Options::get().enableClientsOutput) ? test::popenOutput::EnableALL : test::popenOutput::DisableAll;
+    FILE* fp = test::popen2(command, args, "r", pid, mode);
+    if (!fp)
+        return std::unique_ptr<sessionInfo>();
+
+    // Client must open ipc socket in 25 seconds and initialize in initializeTime of the config
+    // It is ready as soon as it answers the requests
+    size_t const maxSeconds = 25 + _config.cfgFile().initializeTime();
+    if (!waitForClient(Socket::SocketType::IPC, ipcPath, chrono::steady_clock::now() + chrono::seconds(maxSeconds)))
+    {
+        test::pclose2(fp, pid);
+        boost::filesystem::remove_all(tmpDir);
+        return std::unique_ptr<sessionInfo>();
+    }
+    return std::unique_ptr<sessionInfo>(new sessionInfo(
+        fp, new RPCSession(new RPCImpl(Socket::SocketType::IPC, ipcPath)), tmpDir.string(), pid, _config.getId()));
+}
+
+void RPCSession::warmUpInstance(ClientConfig const& _config)
+{
+    std::unique_ptr<sessionInfo> info = startIPCInstance(_config);
+    if (info == nullptr)
+    {
+        ETH_LOG("Failed to start a replacement instance of '" + _config.cfgFile().name() + "'", 1);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_warmSessionsMutex);
+    g_warmSessions.push_back(std::move(*info));
+}
+
+void RPCSession::prewarmReplacement(ClientConfig const& _config)
+{
+    std::unique_ptr<sessionInfo> fresh = startIPCInstance(_config);
+    std::lock_guard<std::mutex> lock(g_warmSessionsMutex);
+    if (fresh == nullptr)
+    {
+        ETH_WARNING("Failed to start a new client instance, continue with the old instance");
+        g_recyclePid = 0;
+        return;
+    }
+    g_recycleReplacement = std::move(fresh);
+}
+
+void RPCSession::recycleExhaustedInstance(thread::id const& _threadID)
+{
+    ClientConfig const& curCFG = Options::getDynamicOptions().getCurrentConfig();
+    ClientConfigFile const& cfg = curCFG.cfgFile();
+    if (cfg.recycleMemory() == 0 && cfg.recycleLatency() == 0)
+        return;
+
+    int pid = 0;
+    double latency = 0;
+    size_t lastTicks = 0;
+    chrono::duration<double> sampleTime;
+    SessionKey const key(_threadID, curCFG.getId().id());
+    {
+        std::lock_guard<std::mutex> lock(g_socketMapMutex);
+        if (!socketMap.count(key))
+            return;
+        sessionInfo& info = socketMap.at(key);
+
+        // The replacement is ready, the thread is between tests. The old instance is closed in background
+        std::lock_guard<std::mutex> lockWarm(g_warmSessionsMutex);
+        if (g_recyclePid == info.pipePid && g_recycleReplacement != nullptr)
+        {
+            sessionInfo retired(std::move(info));
+            info = std::move(*g_recycleReplacement);
+            info.isUsed = retired.isUsed;
+            g_recycleReplacement.reset();
+            g_recyclePid = 0;
+            ETH_LOG("Replaced client instance (pid " + test::fto_string(retired.pipePid) + ") with pid " +
+                        test::fto_string(info.pipePid), 1);
+            startBackgroundTask(retireSession, std::move(retired));
+            return;
+        }
+
+        auto const now = chrono::steady_clock::now();
+        if (now - info.lastSample < c_sampleInterval || g_recyclePid == info.pipePid)
+            return;
+        sampleTime = now - info.lastSample;
+        info.lastSample = now;
+        pid = info.pipePid;
+        lastTicks = info.cpuTicks;
+        latency = info.session.get()->getImplementation().getAverageLatency();
+    }
+
+    size_t const memoryMB = processTreeMemory(pid) / (1024 * 1024);
+    size_t const latencyMS = latency * 1000;
+    size_t const ticks = processTreeCpuTicks(pid);
+    size_t const cpuPercent =
+        lastTicks == 0 ? 0 : (ticks - std::min(ticks, lastTicks)) * 100 / sysconf(_SC_CLK_TCK) / sampleTime.count();
+    string const usage = "memory " + test::fto_string(memoryMB) + " MB, cpu " + test::fto_string(cpuPercent) +
+                         "%, latency " + test::fto_string(latencyMS) + " ms";
+    ETH_LOG("Client instance (pid " + test::fto_string(pid) + ") " + usage, 6);
+
+    std::lock_guard<std::mutex> lock(g_socketMapMutex);
+    if (socketMap.count(key) && socketMap.at(key).pipePid == pid)
+        socketMap.at(key).cpuTicks = ticks;
+    bool const exhausted = (cfg.recycleMemory() && memoryMB > cfg.recycleMemory()) ||
+                           (cfg.recycleLatency() && latencyMS > cfg.recycleLatency());
+    if (!exhausted)
+        return;
+
+    // Other threads keep running on their instances, this one keeps working until the replacement is ready
+    std::lock_guard<std::mutex> lockWarm(g_warmSessionsMutex);
+    if (g_recyclePid != 0)
+        return;
+    ETH_LOG("Restart client instance (pid " + test::fto_string(pid) + ") that reached the limits: " + usage, 1);
+    g_recyclePid = pid;
+    startBackgroundTask(&RPCSession::prewarmReplacement, std::cref(curCFG));
+}
+
 void RPCSession::currentCfgCountTestRun()
 {
     std::lock_guard<std::mutex> lock(g_socketMapMutex);
@@ -165,15 +538,26 @@ void RPCSession::currentCfgCountTestRun()
     {
         sessionInfo& info = el.second;
         if (info.configId.id() == curCFG.getId().id())
+        {
             info.totalRuns++;
+            if (info.totalRuns == c_prewarmBeforeFlush && curCFG.cfgFile().socketType() == ClientConfgSocketType::IPC &&
+                !hasRecycleLimits(curCFG))
+            {
+                std::lock_guard<std::mutex> lockWarm(g_warmSessionsMutex);
+                startBackgroundTask(&RPCSession::warmUpInstance, std::cref(curCFG));
+            }
+        }
     }
 }
 
 bool RPCSession::isRunningTooLong()
 {
-    static const size_t c_maxTestBeforeFlush = 1500;
     std::lock_guard<std::mutex> lock(g_socketMapMutex);
     ClientConfig const& curCFG = Options::getDynamicOptions().getCurrentConfig();
+
+    // Instances are restarted one by one when they reach the limits
+    if (hasRecycleLimits(curCFG))
+        return false;
     for (auto const& el : socketMap)
     {
         sessionInfo const& info = el.second;
@@ -199,14 +583,17 @@ void RPCSession::restartScripts(bool _stop)
         auto stop = [&curCFG](){
             if (fs::exists(curCFG.getStopperScript().c_str()))
             {
-                // Close all active connection listeners
+                // Close active connection listeners of this config
                 ETH_LOG("Restart Client Scripts...", 1);
-                RPCSession::clear();
+                RPCSession::clear(curCFG.getId());
             }
         };
         switch (curCFG.cfgFile().socketType())
         {
-        case ClientConfgSocketType::IPC: stop(); return;
+        case ClientConfgSocketType::IPC:
+            if (!replaceWithWarmSessions(curCFG.getId()))
+                stop();
+            return;
         case ClientConfgSocketType::TCP: stop(); return;
         default: break;
         }
@@ -214,8 +601,7 @@ void RPCSession::restartScripts(bool _stop)
     }
 
     // If there are no clients started with this configuration, run the start script
-    // Assume here that socketMap is open for single configuration at a time only
-    if (socketMap.empty())
+    if (configSessions(curCFG.getId()) == 0)
     {
         if (!fs::exists(curCFG.getStartScript()))
             return;
@@ -232,9 +618,9 @@ void RPCSession::restartScripts(bool _stop)
             thread task(cmd, start, test::fto_string(threads) + " 2>/dev/null");
             ETH_LOG(start, 1);
             task.detach();
-            size_t const initTime = curCFG.cfgFile().initializeTime();
-            size_t const seconds = Options::get().lowcpu ? initTime * 5 : initTime;
-            this_thread::sleep_for(chrono::seconds(seconds));
+
+            // The caller waits until the clients answer (waitForStartedClients)
+            g_startingConfigs.insert(curCFG.getId().id());
         }
         break;
         default:
@@ -245,121 +631,202 @@ void RPCSession::restartScripts(bool _stop)
 
 SessionInterface& RPCSession::instance(thread::id const& _threadID)
 {
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
+    std::unique_lock<std::mutex> lock(g_socketMapMutex);
     bool needToCreateNew = false;
     test::ClientConfigID currentConfigId = Options::getDynamicOptions().getCurrentConfig().getId();
-    if (socketMap.count(_threadID) && socketMap.at(_threadID).configId != currentConfigId)
-    {
-        // For this thread a session is opened but it is opened not for current tested client
-        ETH_FAIL_MESSAGE("A session opened for another client id!");
-    }
+    SessionKey const key = sessionKey(_threadID);
 
     // If there are no clients running, instantiate them with starter scripts
+    // The start is reserved in g_startingConfigs, the clients are probed without the lock
+    unsigned const configId = currentConfigId.id();
+    g_clientsStarted.wait(lock, [configId]() { return !g_startingConfigs.count(configId); });
     restartScripts();
+    if (g_startingConfigs.count(configId))
+    {
+        lock.unlock();
+        waitForStartedClients(Options::getDynamicOptions().getCurrentConfig());
+        lock.lock();
+        g_startingConfigs.erase(configId);
+        g_clientsStarted.notify_all();
+    }
 
-    if (!socketMap.count(_threadID))
+    if (!socketMap.count(key))
     {
         // look for free clients that already instantiated
-        for (auto& socket : socketMap)
-        {
-            if (socket.second.isUsed == SessionStatus::Available)
-                if (socket.second.configId == currentConfigId)
-                {
-                    socket.second.isUsed = SessionStatus::Working;
-                    socketMap.insert(std::pair<thread::id, sessionInfo>(_threadID, std::move(socket.second)));
-                    socketMap.erase(socketMap.find(socket.first));  // remove previous threadID assigment to this socket
-                    assert(socketMap.count(_threadID));
-                    return socketMap.at(_threadID).session.get()->getImplementation();
-                }
-        }
+        if (assignAvailableSession(_threadID, currentConfigId))
+            return socketMap.at(key).session.get()->getImplementation();
         needToCreateNew = true;
     }
     if (needToCreateNew)
     {
         size_t const threadID = std::hash<std::thread::id>()(_threadID);
         ETH_LOG("Run new connection session for `" + test::fto_string(threadID) + "`", 2);
-        runNewInstanceOfAClient(_threadID, Options::getDynamicOptions().getCurrentConfig());
+        runNewInstanceOfAClient(_threadID, Options::getDynamicOptions().getCurrentConfig(), lock);
         ETH_LOG("New instance started", 2);
     }
 
-    ETH_FAIL_REQUIRE_MESSAGE(socketMap.size() <= Options::get().threadCount,
+    size_t const sessions = configSessions(currentConfigId);
+    ETH_FAIL_REQUIRE_MESSAGE(sessions <= Options::get().threadCount,
         "Something went wrong. Retesteth connect to more instances than needed!");
-    ETH_FAIL_REQUIRE_MESSAGE(socketMap.size() != 0, "Something went wrong. Retesteth failed to create socket connection!");
+    ETH_FAIL_REQUIRE_MESSAGE(sessions != 0, "Something went wrong. Retesteth failed to create socket connection!");
     size_t const threadID = std::hash<std::thread::id>()(_threadID);
     ETH_FAIL_REQUIRE_MESSAGE(
-        socketMap.count(_threadID), "ThreadID: `" + fto_string(threadID) + "` not registered in socketMap!");
-    return socketMap.at(_threadID).session.get()->getImplementation();
+        socketMap.count(key), "ThreadID: `" + fto_string(threadID) + "` not registered in socketMap!");
+    return socketMap.at(key).session.get()->getImplementation();
 }
 
 void RPCSession::sessionStart(thread::id const& _threadID)
 {
+    recycleExhaustedInstance(_threadID);
     RPCSession::instance(_threadID);  // initialize the client if not exist
     std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    if (socketMap.count(_threadID))
-        socketMap.at(_threadID).isUsed = SessionStatus::Working;
+    SessionKey const key = sessionKey(_threadID);
+    if (socketMap.count(key))
+        socketMap.at(key).isUsed = SessionStatus::Working;
 }
 
 void RPCSession::sessionEnd(thread::id const& _threadID, SessionStatus _status)
 {
+    // A thread works with one session at a time, the other sessions of the thread are idle already
+    // Sessions of all configs are released when the pool is stopped
     std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    if (socketMap.count(_threadID))
-        socketMap.at(_threadID).isUsed = _status;
+    for (auto& socket : socketMap)
+        if (socket.first.first == _threadID)
+            socket.second.isUsed = _status;
 }
 
 RPCSession::SessionStatus RPCSession::sessionStatus(thread::id const& _threadID)
 {
     std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    if (socketMap.count(_threadID))
-        return socketMap.at(_threadID).isUsed;
+    SessionKey const key = sessionKey(_threadID);
+    if (socketMap.count(key))
+        return socketMap.at(key).isUsed;
     return RPCSession::NotExist;
 }
 
-void closeSession(thread::id const& _threadID)
+void closeSession(SessionKey const& _key)
+{
+    ETH_FAIL_REQUIRE_MESSAGE(socketMap.count(_key), "Socket map is empty in closeSession!");
+    closeSessionInfo(socketMap.at(_key));
+}
+
+void closeSessionInfo(sessionInfo& element)
 {
-    ETH_FAIL_REQUIRE_MESSAGE(socketMap.count(_threadID), "Socket map is empty in closeSession!");
-    sessionInfo& element = socketMap.at(_threadID);
     if (element.session.get()->getImplementation().getSocketType() == Socket::SocketType::IPC)
     {
+        // The client has to exit before its tmp directory is removed
+        std::vector<int> const tree = processTree(element.pipePid);
         test::pclose2(element.filePipe.get(), element.pipePid);
-        std::this_thread::sleep_for(std::chrono::seconds(4));
+        if (element.pipePid != 0 && !waitForProcessesExit(tree, chrono::steady_clock::now() + c_clientExitTimeout))
+            ETH_WARNING("Client instance (pid " + test::fto_string(element.pipePid) + ") did not exit in " +
+                        test::fto_string(c_clientExitTimeout.count()) + " seconds after the kill signal");
         boost::filesystem::remove_all(boost::filesystem::path(element.tmpDir));
         element.filePipe.release();
         element.session.release();
     }
 }
 
-void RPCSession::clear()
+// Run the stopper script of the config and wait until its clients stop
+void stopClients(ClientConfig const& _config)
 {
-    // Close all active connection listeners
-    std::lock_guard<std::mutex> lock(g_socketMapMutex);
-    std::vector<thread> closingThreads;
-    for (auto& element : socketMap)
+    if (_config.getStopperScript().empty() || Options::get().nodesoverride.size() > 0)
+        return;
+    executeCmd(_config.getStopperScript().c_str(), ExecCMDWarning::NoWarningNoError);
+    ETH_LOG(_config.getStopperScript().c_str(), 1);
+    if (!ExitHandler::receivedExitSignal())
     {
-        thread t(closeSession, element.first);
-        closingThreads.push_back(std::move(t));
+        size_t const initTime = _config.cfgFile().initializeTime();
+        size_t const seconds = Options::get().lowcpu ? initTime + 10 : initTime;
+        if (_config.cfgFile().socketType() == ClientConfgSocketType::TCP)
+        {
+            // Wait until the clients stop answering, initializeTime is the upper limit
+            auto const deadline = chrono::steady_clock::now() + chrono::seconds(seconds);
+            auto clientsAnswer = [&_config]() {
+                for (auto const& addr : _config.cfgFile().socketAdresses())
+                    if (Socket::probe(Socket::SocketType::TCP, addr.asString(), 200))
+                        return true;
+                return false;
+            };
+            while (chrono::steady_clock::now() < deadline && clientsAnswer())
+                this_thread::sleep_for(chrono::milliseconds(100));
+        }
+        else
+            this_thread::sleep_for(chrono::seconds(seconds));
     }
-    for (auto& th : closingThreads)
-        th.join();
+}
 
-    socketMap.clear();
-    closingThreads.clear();
+// Close the sessions of the config (all sessions if _configId is null) and stop the clients
+void clearSessions(test::ClientConfigID const& _configId)
+{
+    bool const all = _configId == test::ClientConfigID::null();
+    auto const matches = [&_configId, all](test::ClientConfigID const& _id) { return all || _id == _configId; };
 
-    // If not running UnitTests or smth
-    if (Options::getDynamicOptions().activeConfigs() > 0 && Options::getDynamicOptions().currentConfigIsSet())
+    // Finish starting and closing of instances in background, then close the prewarmed instances too
+    std::vector<thread> closingThreads;
     {
-        ClientConfig const& curCFG = Options::getDynamicOptions().getCurrentConfig();
-        if (!curCFG.getStopperScript().empty() && Options::get().nodesoverride.size() == 0)
+        std::unique_lock<std::mutex> lock(g_warmSessionsMutex);
+        g_backgroundTasksDone.wait(lock, []() { return g_backgroundTasks == 0; });
+        if (g_recycleReplacement != nullptr && matches(g_recycleReplacement->configId))
         {
-            executeCmd(curCFG.getStopperScript().c_str(), ExecCMDWarning::NoWarningNoError);
-            ETH_LOG(curCFG.getStopperScript().c_str(), 1);
-            if (!ExitHandler::receivedExitSignal())
-            {
-                size_t const initTime = curCFG.cfgFile().initializeTime();
-                size_t const seconds = Options::get().lowcpu ? initTime + 10 : initTime;
-                this_thread::sleep_for(chrono::seconds(seconds));
-            }
+            closingThreads.push_back(thread(retireSession, std::move(*g_recycleReplacement)));
+            g_recycleReplacement.reset();
+            g_recyclePid = 0;
+        }
+        std::vector<sessionInfo> keep;
+        for (auto& info : g_warmSessions)
+        {
+            if (matches(info.configId))
+                closingThreads.push_back(thread(retireSession, std::move(info)));
+            else
+                keep.push_back(std::move(info));
+        }
+        g_warmSessions.swap(keep);
+    }
+
+    // Close active connection listeners
+    std::set<unsigned> stoppedConfigs;
+    {
+        std::lock_guard<std::mutex> lock(g_socketMapMutex);
+        for (auto const& element : socketMap)
+        {
+            if (!matches(element.second.configId))
+                continue;
+            stoppedConfigs.insert(element.first.second);
+            closingThreads.push_back(thread(closeSession, element.first));
+        }
+        for (auto& th : closingThreads)
+            th.join();
+        closingThreads.clear();
+        for (auto it = socketMap.begin(); it != socketMap.end();)
+        {
+            if (matches(it->second.configId))
+                it = socketMap.erase(it);
+            else
+                it++;
         }
     }
+
+    // If not running UnitTests or smth
+    Options::DynamicOptions& dynamicOptions = Options::getDynamicOptions();
+    if (dynamicOptions.activeConfigs() == 0 || !dynamicOptions.currentConfigIsSet())
+        return;
+    if (all)
+        stoppedConfigs.insert(dynamicOptions.getCurrentConfig().getId().id());
+    else
+        stoppedConfigs = {_configId.id()};
+    for (auto const& config : dynamicOptions.getClientConfigs())
+        if (stoppedConfigs.count(config.getId().id()))
+            stopClients(config);
+}
+
+void RPCSession::clear()
+{
+    clearSessions(test::ClientConfigID::null());
+}
+
+void RPCSession::clear(test::ClientConfigID const& _configId)
+{
+    clearSessions(_configId);
 }
 
 RPCSession::RPCSession(SessionInterface* _impl) : m_implementation(_impl) {}
@@ -4,6 +4,8 @@
 #include <boost/noncopyable.hpp>
 #include <boost/test/unit_test.hpp>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
@@ -12,6 +14,7 @@
 #include <retesteth/session/SessionInterface.h>
 
 using namespace dataobject;
+struct sessionInfo;
 
 // Session connections to an instance of a client
 class RPCSession : public boost::noncopyable
@@ -29,7 +32,8 @@ public:
     static void sessionStart(thread::id const& _threadID);
     static void sessionEnd(thread::id const& _threadID, SessionStatus _status);
     static SessionStatus sessionStatus(thread::id const& _threadID);
-    static void clear();
+    static void clear();                                    // Close all sessions
+    static void clear(test::ClientConfigID const& _configId);  // Close the sessions of the config
 
     // Flush the memory by restarting the clients with configuration scripts
     static void currentCfgCountTestRun();            // Increase test run counter
@@ -41,6 +45,21 @@ public:
 
 private:
     explicit RPCSession(SessionInterface* _impl);
-    static void runNewInstanceOfAClient(thread::id const& _threadID, test::ClientConfig const& _config);
+    // _lock holds g_socketMapMutex, it is released while an ipc instance starts
+    static void runNewInstanceOfAClient(
+        thread::id const& _threadID, test::ClientConfig const& _config, std::unique_lock<std::mutex>& _lock);
+
+    // Run the client with the config script and wait until it answers on ipc, nullptr if it did not start
+    static std::unique_ptr<sessionInfo> startIPCInstance(test::ClientConfig const& _config);
+
+    // Start a replacement instance in background for the flush of a long running session
+    static void warmUpInstance(test::ClientConfig const& _config);
+
+    // Start the replacement of the instance that passed the limits, recycleExhaustedInstance swaps them
+    static void prewarmReplacement(test::ClientConfig const& _config);
+
+    // Sample memory, cpu and latency of the instance of the thread. If it passed memory or latency
+    // limits of the config, prewarm a replacement and swap the instances when it is ready
+    static void recycleExhaustedInstance(thread::id const& _threadID);
     SessionInterface* m_implementation;
 };
@@ -2,6 +2,8 @@
 #include "Socket.h"
 #include <retesteth/dataObject/DataObject.h>
 #include <retesteth/testStructures/basetypes.h>
+#include <retesteth/testStructures/types/Ethereum/Base/AccountBase.h>
+#include <retesteth/testStructures/types/Ethereum/Transaction.h>
 #include <retesteth/testStructures/types/rpc.h>
 #include <string>
 
@@ -63,6 +65,13 @@ public:
         FH32 const& _blockHash, VALUE const& _txIndex, FH20 const& _addrHash, FH32 const& _begin, int _maxResults) = 0;
     virtual DebugVMTrace debug_traceTransaction(FH32 const& _trHash) = 0;
 
+    // Read balance, nonce, code and full storage of the accounts at the state after _txIndex
+    // Returns State::Account objects in the order of _addresses
+    // With _sizeLimit != 0 the storage is read only until the accounts take more than _sizeLimit bytes
+    // (64 bytes per storage record and the code size), the returned storage is incomplete then
+    virtual std::vector<spAccountBase> debug_getAccountsBatch(
+        VALUE const& _blockNumber, VALUE const& _txIndex, std::vector<FH20> const& _addresses, size_t _sizeLimit) = 0;
+
     // Test
     virtual void test_setChainParams(spSetChainParamsArgs const& _config) = 0;
     virtual void test_rewindToBlock(VALUE const& _blockNr) = 0;
@@ -74,12 +83,21 @@ public:
     virtual VALUE test_calculateDifficulty(FORK const& _fork, VALUE const& _blockNumber, VALUE const& _parentTimestamp,
         VALUE const& _parentDifficulty, VALUE const& _currentTimestamp, VALUE const& _uncleNumber) = 0;
 
+    // Calculate difficulty for the list of test vectors of the same fork
+    virtual std::vector<VALUE> test_calculateDifficulty(
+        FORK const& _fork, std::vector<CalculateDifficultyArgs> const& _args) = 0;
+
+    // Mine each transaction in its own block on top of the genesis with _timestamp, rewind to genesis after each
+    virtual std::vector<MineTransactionResult> test_mineTransactionsBatch(
+        std::vector<spTransaction> const& _txs, VALUE const& _timestamp) = 0;
+
     // Internal
     virtual spDataObject rpcCall(std::string const& _methodName,
         std::vector<std::string> const& _args = std::vector<std::string>(),
         bool _canFail = false) = 0;
     virtual Socket::SocketType getSocketType() const = 0;
     virtual std::string const& getSocketPath() const = 0;
+    virtual double getAverageLatency() const = 0;
 
     RPCError const& getLastRPCError() const { return m_lastInterfaceError; }
     virtual ~SessionInterface() {}
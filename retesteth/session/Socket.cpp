@@ -2,9 +2,35 @@
 #include <curl/curl.h>
 #include <retesteth/EthChecks.h>
 #include <retesteth/ExitHandler.h>
+#include <retesteth/TestHelper.h>
+#include <cstring>
+#include <mutex>
 
 using namespace std;
 
+namespace
+{
+struct SocketLatency
+{
+    size_t requests = 0;
+    size_t connects = 0;
+    double totalTime = 0;
+    double maxTime = 0;
+};
+std::mutex g_socketLatencyMutex;
+SocketLatency g_socketLatency[2];  // IPC, TCP
+
+void recordLatency(Socket::SocketType _type, double _seconds, size_t _connects)
+{
+    std::lock_guard<std::mutex> lock(g_socketLatencyMutex);
+    SocketLatency& stats = g_socketLatency[_type];
+    stats.requests++;
+    stats.connects += _connects;
+    stats.totalTime += _seconds;
+    stats.maxTime = std::max(stats.maxTime, _seconds);
+}
+}  // namespace
+
 Socket::Socket(SocketType _type, string const& _path) : m_path(_path), m_socketType(_type)
 {
 #if defined(_WIN32)
@@ -114,78 +140,65 @@ string sendRequestWin(string const& _req)
     return string(m_readBuf, m_readBuf + cbRead);
 }
 #endif
+}  // namespace
 
-struct WriteThis
-{
-    const char* readptr;
-    size_t sizeleft;
-};
-
-static size_t readcallback(void* dest, size_t size, size_t nmemb, void* userp)
+Socket::~Socket()
 {
-    struct WriteThis* wt = (struct WriteThis*)userp;
-    size_t buffer_size = size * nmemb;
-
-    if (wt->sizeleft)
+    if (m_curl != nullptr)
     {
-        /* copy as much as possible from the source to the destination */
-        size_t copy_this_much = wt->sizeleft;
-        if (copy_this_much > buffer_size)
-            copy_this_much = buffer_size;
-        memcpy(dest, wt->readptr, copy_this_much);
-
-        wt->readptr += copy_this_much;
-        wt->sizeleft -= copy_this_much;
-
-        return copy_this_much; /* we copied this many bytes */
+        curl_slist_free_all(m_curlHeader);
+        curl_easy_cleanup(m_curl);
     }
+    if (m_socket >= 0)
+        close(m_socket);
+}
 
-    return 0; /* no more data left to deliver */
+void Socket::recordRequestTime(double _seconds, size_t _connects)
+{
+    m_lastRequestTime = _seconds;
+    recordLatency(m_socketType, _seconds, _connects);
 }
 
-string sendRequestTCP(string const& _req, string const& _address)
+string Socket::sendRequestTCP(string const& _req)
 {
-    CURL* curl;
-    CURLcode res;
-    curl = curl_easy_init();
-
-    string url = _address;
-    if (_address.find("http") == string::npos)
-        url = "http://" + _address;
-    if (curl)
+    if (m_curl == nullptr)
     {
-        std::unique_ptr<std::string> httpData(new std::string());
-        struct WriteThis wt;
-        wt.readptr = _req.c_str();
-        wt.sizeleft = _req.size();
+        m_curl = curl_easy_init();
+        if (m_curl == nullptr)
+            ETH_FAIL_MESSAGE("Error initializing Curl");
+
+        string url = m_path;
+        if (m_path.find("http") == string::npos)
+            url = "http://" + m_path;
+        curl_easy_setopt(m_curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(m_curl, CURLOPT_BUFFERSIZE, 3000000);
+        curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, writecallback);
+        curl_easy_setopt(m_curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(m_curl, CURLOPT_TCP_NODELAY, 1L);
+        curl_easy_setopt(m_curl, CURLOPT_TCP_KEEPALIVE, 1L);
+
+        // Request size is known, so the body is sent with Content-Length instead of chunked encoding
+        m_curlHeader = curl_slist_append(m_curlHeader, "Accept: application/json, text/plain");
+        m_curlHeader = curl_slist_append(m_curlHeader, "Content-Type: application/json");
+        curl_easy_setopt(m_curl, CURLOPT_HTTPHEADER, m_curlHeader);
+        curl_easy_setopt(m_curl, CURLOPT_TIMEOUT, 500L);
+    }
 
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 3000000);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writecallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, httpData.get());
-        curl_easy_setopt(curl, CURLOPT_READFUNCTION, readcallback);
-        curl_easy_setopt(curl, CURLOPT_READDATA, &wt);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    string httpData;
+    curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &httpData);
+    curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, _req.c_str());
+    curl_easy_setopt(m_curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)_req.size());
 
-        struct curl_slist* header = NULL;
-        header = curl_slist_append(header, "Accept: application/json, text/plain");
-        header = curl_slist_append(header, "Content-Type: application/json");
-        header = curl_slist_append(header, "Transfer-Encoding: chunked");
+    auto const start = chrono::steady_clock::now();
+    CURLcode const res = curl_easy_perform(m_curl);
+    long connects = 0;
+    curl_easy_getinfo(m_curl, CURLINFO_NUM_CONNECTS, &connects);
+    recordRequestTime(chrono::duration<double>(chrono::steady_clock::now() - start).count(), connects);
 
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 500L);
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK && !ExitHandler::receivedExitSignal())
-            ETH_FAIL_MESSAGE("curl_easy_perform() failed " + string(curl_easy_strerror(res)));
-        curl_slist_free_all(header);
-        curl_easy_cleanup(curl);
-        return *httpData.get();
-    }
-    else
-        ETH_FAIL_MESSAGE("Error initializing Curl");
-    return string();
+    if (res != CURLE_OK && !ExitHandler::receivedExitSignal())
+        ETH_FAIL_MESSAGE("curl_easy_perform() failed " + string(curl_easy_strerror(res)));
+    return httpData;
 }
-}  // namespace
 
 string Socket::sendRequestIPC(string const& _req, SocketResponseValidator& _validator)
 {
@@ -198,30 +211,36 @@ string Socket::sendRequestIPC(string const& _req, SocketResponseValidator& _vali
         ETH_FAIL_MESSAGE("Writing on socket failed.");
 
     auto start = chrono::steady_clock::now();
-    ssize_t ret = 0;
-    string reply;
+    if (!m_pending.empty())
+    {
+        size_t const used = _validator.acceptResponse(m_pending.data(), m_pending.size());
+        m_pending.erase(0, used);
+    }
 
     while (
         _validator.completeResponse() == false &&
         chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count() <
             m_readTimeOutMS)
     {
-        ret = recv(m_socket, m_readBuf, sizeof(m_readBuf), 0);
+        ssize_t const ret = recv(m_socket, m_readBuf, sizeof(m_readBuf), 0);
 
         // Also consider closed socket an error.
         if (ret < 0)
             ETH_FAIL_MESSAGE("Reading on socket failed!");
+        if (ret == 0)
+            break;
 
-        _validator.acceptResponse(m_readBuf);
-        memset(&m_readBuf[0], 0, sizeof(m_readBuf));
+        // Keep the bytes of the next response for the next request
+        size_t const used = _validator.acceptResponse(m_readBuf, (size_t)ret);
+        if (used < (size_t)ret)
+            m_pending.append(m_readBuf + used, (size_t)ret - used);
     }
 
-    reply = _validator.getResponse();
-
-    if (ret == 0)
+    if (!_validator.completeResponse())
         ETH_FAIL_MESSAGE("Timeout reading on socket.");
 
-    return reply;
+    recordRequestTime(chrono::duration<double>(chrono::steady_clock::now() - start).count(), 0);
+    return _validator.takeResponse();
 }
 
 string Socket::sendRequest(string const& _req, SocketResponseValidator& _val)
@@ -231,7 +250,7 @@ string Socket::sendRequest(string const& _req, SocketResponseValidator& _val)
 #endif
 
     if (m_socketType == Socket::TCP)
-        return sendRequestTCP(_req, m_path);
+        return sendRequestTCP(_req);
 
     if (m_socketType == Socket::IPC)
         return sendRequestIPC(_req, _val);
@@ -239,29 +258,150 @@ string Socket::sendRequest(string const& _req, SocketResponseValidator& _val)
     return string();
 }
 
+bool Socket::probe(SocketType _type, string const& _path, unsigned _timeoutMS)
+{
+    string const request = "{\"jsonrpc\":\"2.0\",\"method\":\"web3_clientVersion\",\"params\":[],\"id\":1}";
+    if (_type == Socket::TCP)
+    {
+        CURL* curl = curl_easy_init();
+        if (curl == nullptr)
+            return false;
+        string const url = _path.find("http") == string::npos ? "http://" + _path : _path;
+        string reply;
+        struct curl_slist* header = curl_slist_append(NULL, "Content-Type: application/json");
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writecallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &reply);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)_timeoutMS);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        CURLcode const res = curl_easy_perform(curl);
+        curl_slist_free_all(header);
+        curl_easy_cleanup(curl);
+        return res == CURLE_OK && reply.find("\"result\"") != string::npos;
+    }
+
+    if (_path.length() >= sizeof(sockaddr_un::sun_path))
+        return false;
+    struct sockaddr_un saun;
+    memset(&saun, 0, sizeof(sockaddr_un));
+    saun.sun_family = AF_UNIX;
+    strcpy(saun.sun_path, _path.c_str());
+#if defined(__APPLE__)
+    saun.sun_len = sizeof(struct sockaddr_un);
+#endif
+
+    int const sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0)
+        return false;
+    struct timeval timeout;
+    timeout.tv_sec = _timeoutMS / 1000;
+    timeout.tv_usec = (_timeoutMS % 1000) * 1000;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+#if defined(MSG_NOSIGNAL)
+    int const sendFlags = MSG_NOSIGNAL;  // client might close the socket while starting
+#else
+    int const sendFlags = 0;
+#endif
+
+    JsonObjectValidator validator;
+    if (connect(sock, reinterpret_cast<struct sockaddr const*>(&saun), sizeof(struct sockaddr_un)) == 0 &&
+        send(sock, request.c_str(), request.length(), sendFlags) == (ssize_t)request.length())
+    {
+        char buf[4096];
+        ssize_t ret = 0;
+        while (!validator.completeResponse() && (ret = recv(sock, buf, sizeof(buf), 0)) > 0)
+            validator.acceptResponse(buf, (size_t)ret);
+    }
+    close(sock);
+    return validator.completeResponse() && validator.takeResponse().find("\"result\"") != string::npos;
+}
+
+string Socket::latencyStats()
+{
+    std::lock_guard<std::mutex> lock(g_socketLatencyMutex);
+    string stats;
+    for (auto const type : {Socket::IPC, Socket::TCP})
+    {
+        SocketLatency const& el = g_socketLatency[type];
+        if (el.requests == 0)
+            continue;
+        stats += string("RPC ") + (type == Socket::IPC ? "IPC" : "TCP") + " requests: " + test::fto_string(el.requests);
+        if (type == Socket::TCP)
+            stats += ", connections: " + test::fto_string(el.connects);
+        stats += ", avg: " + test::fto_string(el.totalTime * 1000 / el.requests) + " ms";
+        stats += ", max: " + test::fto_string(el.maxTime * 1000) + " ms\n";
+    }
+    return stats;
+}
+
 JsonObjectValidator::JsonObjectValidator()
 {
     m_status = false;
+    m_inString = false;
+    m_escape = false;
     m_bracersCount = 0;
     m_response = string();
 }
-void JsonObjectValidator::acceptResponse(std::string const& _response)
+
+size_t JsonObjectValidator::acceptResponse(char const* _data, size_t _size)
 {
-    for (size_t i = 0; i < _response.size(); i++)
+    // Skip the delimiters between responses (clients end responses with a new line)
+    size_t begin = 0;
+    while (m_response.empty() && begin < _size && isspace((unsigned char)_data[begin]))
+        begin++;
+
+    size_t i = begin;
+    while (i < _size && !m_status)
     {
-        m_response += _response[i];
-        if (_response[i] == '{')
-            m_bracersCount++;
-        else if (_response[i] == '}')
+        if (m_escape)
+        {
+            m_escape = false;
+            i++;
+        }
+        else if (m_inString)
+        {
+            // Jump to the end of the string, braces inside of the string are not counted
+            char const* quote = (char const*)memchr(_data + i, '"', _size - i);
+            size_t const end = quote ? quote - _data : _size;
+            char const* slash = (char const*)memchr(_data + i, '\\', end - i);
+            if (slash)
+            {
+                i = slash - _data + 1;
+                m_escape = true;
+            }
+            else
+            {
+                i = quote ? end + 1 : _size;
+                m_inString = quote == nullptr;
+            }
+        }
+        else
         {
-            m_bracersCount--;
-            if (m_bracersCount == 0)
+            switch (_data[i++])
             {
-                m_status = true;
+            case '"':
+                m_inString = true;
+                break;
+            case '{':
+            case '[':
+                m_bracersCount++;
+                break;
+            case '}':
+            case ']':
+                if (--m_bracersCount == 0)
+                    m_status = true;
+                break;
+            default:
                 break;
             }
         }
     }
+    m_response.append(_data + begin, i - begin);
+    return i;
 }
 
 bool JsonObjectValidator::completeResponse() const
@@ -269,7 +409,7 @@ bool JsonObjectValidator::completeResponse() const
     return m_status;
 }
 
-std::string const& JsonObjectValidator::getResponse() const
+std::string JsonObjectValidator::takeResponse()
 {
-    return m_response;
+    return std::move(m_response);
 }
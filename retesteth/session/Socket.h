@@ -16,22 +16,26 @@
 class SocketResponseValidator
 {
 public:
-    virtual void acceptResponse(std::string const& _response) = 0;
+    // Accept the next chunk of the stream, returns the number of bytes that belong to the response
+    virtual size_t acceptResponse(char const* _data, size_t _size) = 0;
     virtual bool completeResponse() const = 0;
-    virtual std::string const& getResponse() const = 0;
+    virtual std::string takeResponse() = 0;
 };
 
+// Frames one json value of the stream by counting `{}[]` outside of json strings
 class JsonObjectValidator : public SocketResponseValidator
 {
 public:
     JsonObjectValidator();
-    void acceptResponse(std::string const& _response) override;
+    size_t acceptResponse(char const* _data, size_t _size) override;
     bool completeResponse() const override;
-    std::string const& getResponse() const override;
+    std::string takeResponse() override;
 
 private:
     std::string m_response;
     bool m_status;
+    bool m_inString;
+    bool m_escape;
     int m_bracersCount;
 };
 
@@ -61,19 +65,38 @@ public:
     };
     explicit Socket(SocketType _type, std::string const& _path);
     std::string sendRequest(std::string const& _req, SocketResponseValidator& _responseValidator);
-    ~Socket() { close(m_socket); }
+    ~Socket();
 
     std::string const& path() const { return m_path; }
     SocketType type() const { return m_socketType; }
 
+    // Duration of the last request of this socket in seconds
+    double lastRequestTime() const { return m_lastRequestTime; }
+
+    // Request count and latency of all sockets of the run
+    static std::string latencyStats();
+
+    // True if the client answers web3_clientVersion on _path within _timeoutMS
+    // Unlike the Socket constructor does not fail the test when the client is not reachable
+    static bool probe(SocketType _type, std::string const& _path, unsigned _timeoutMS);
+
 private:
     std::string m_path;
-    int m_socket;
+    int m_socket = -1;
     SocketType m_socketType;
+
+    // Curl handle is kept for the socket lifetime so the HTTP connection is reused (keep-alive)
+    void* m_curl = nullptr;
+    struct curl_slist* m_curlHeader = nullptr;
+    std::string sendRequestTCP(std::string const& _req);
+
+    double m_lastRequestTime = 0;
+    void recordRequestTime(double _seconds, size_t _connects);
     /// Socket read timeout in milliseconds. Needs to be large because the key generation routine
     /// might take long.
     unsigned static constexpr m_readTimeOutMS = 130000;
     char m_readBuf[512000];
+    std::string m_pending;  // Bytes received after the end of the previous response
     std::string sendRequestIPC(std::string const& _req, SocketResponseValidator& _val);
 };
 #endif
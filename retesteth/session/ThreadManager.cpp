@@ -2,123 +2,278 @@
 #include "ThreadManager.h"
 #include <retesteth/Options.h>
 #include <retesteth/ExitHandler.h>
+#include <retesteth/TestOutputHelper.h>
 #include <condition_variable>
+#include <exception>
+#include <mutex>
 
-size_t g_activejobs = 0;
-std::mutex g_jobsmutex;
-std::condition_variable g_cv;
-std::mutex g_callbackmutex;
-unsigned int ThreadManager::currConfigId = 0;
-map<thread::id, thread> ThreadManager::threadMap;
+// Jobs are test files and their units which take milliseconds at least
+// One mutex for the queue and all deques is enough
+// Any idle worker could take any job, so one worker is woken per new job
+std::mutex g_poolMutex;
+std::condition_variable g_poolCv;  // new job, a free config slot or the pool is stopping
+std::condition_variable g_doneCv;  // a job has finished
+size_t g_pendingTasks = 0;         // queued or running tasks
+size_t g_idleWorkers = 0;
+bool g_stopPool = false;
+thread_local int t_workerID = -1;
+
+std::vector<std::unique_ptr<ThreadManager::Worker>> ThreadManager::workers;
+std::deque<ThreadManager::Task> ThreadManager::taskQueue;
+std::map<unsigned, size_t> ThreadManager::configLimits;
+std::map<unsigned, size_t> ThreadManager::configWorkers;
+std::set<unsigned> ThreadManager::warnedConfigs;
 
 size_t ThreadManager::getMaxAllowedThreads()
 {
     // If debugging, already there is an open instance of a client.
     // Only one thread allowed to connect to it;
-    size_t maxAllowedThreads = Options::get().threadCount;
+    size_t allowedThreads = Options::get().threadCount;
     ClientConfig const& currConfig = Options::get().getDynamicOptions().getCurrentConfig();
-    currConfigId = currConfig.getId().id();
+    bool const firstCall = warnedConfigs.insert(currConfig.getId().id()).second;
     ClientConfgSocketType socType = currConfig.cfgFile().socketType();
     if (socType == ClientConfgSocketType::IPCDebug)
-        maxAllowedThreads = 1;
+        allowedThreads = 1;
 
     // If connecting to TCP sockets. Max threads are limited with tcp ports provided
     if (socType == ClientConfgSocketType::TCP)
     {
-        maxAllowedThreads = min(maxAllowedThreads, currConfig.cfgFile().socketAdresses().size());
-        if (maxAllowedThreads != Options::get().threadCount)
+        allowedThreads = min(allowedThreads, currConfig.cfgFile().socketAdresses().size());
+        if (allowedThreads != Options::get().threadCount && firstCall)
             ETH_WARNING(
-                "Correct -j option to `" + test::fto_string(maxAllowedThreads) + "` (or provide socket ports in config)!");
+                "Correct -j option to `" + test::fto_string(allowedThreads) + "` (or provide socket ports in config)!");
     }
-    return maxAllowedThreads;
+    return allowedThreads;
 }
 
-void ThreadManager::addTask(std::function<void()> _job)
+void ThreadManager::startPool()
 {
+    // Workers look into each other's deques. Create all of them before the threads start
+    // Concurrent configs share the pool, each config is limited in takeJob
+    bool const concurrent = Options::getDynamicOptions().runConfigsConcurrently();
+    size_t const poolSize = max<size_t>(1, concurrent ? Options::get().threadCount : getMaxAllowedThreads());
+    for (size_t i = 0; i < poolSize; i++)
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    for (size_t i = 0; i < poolSize; i++)
+        workers.at(i)->thread = thread(&ThreadManager::workerLoop, i);
+}
+
+void ThreadManager::stopPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        g_stopPool = true;
+    }
+    g_poolCv.notify_all();
+    for (auto& worker : workers)
     {
-         std::lock_guard<std::mutex> lk(g_jobsmutex);
-         g_activejobs++;
+        // Sessions of the workers could be taken by the next pool
+        thread::id const id = worker->thread.get_id();
+        worker->thread.join();
+        RPCSession::sessionEnd(id, RPCSession::SessionStatus::Available);
     }
+    workers.clear();
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    g_stopPool = false;
+}
+
+void ThreadManager::addTask(std::function<void()> _job)
+{
+    if (workers.empty())
+        startPool();
+
+    // The task runs with the config that is current when it is added
+    test::ClientConfigID const configId = Options::getDynamicOptions().getCurrentConfig().getId();
+    size_t const allowedThreads = max<size_t>(1, getMaxAllowedThreads());
+    auto wrappedJob = [_job, configId]() {
+        Options::getDynamicOptions().setThreadConfig(configId);
 
-    auto wrappedJob = [_job](){
-        _job();
-        g_cv.notify_one();
-        std::lock_guard<std::mutex> lk(g_jobsmutex);
-        g_activejobs--;
+        // if one of the tests threads failed with fatal exception skip the rest of the tasks
+        if (!ExitHandler::receivedExitSignal())
+            _job();
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        g_pendingTasks--;
+        g_doneCv.notify_all();
     };
-    thread workThread(wrappedJob);
-    threadMap.emplace(workThread.get_id(), std::move(workThread));
 
-    // See how many connections we can afford on current running configuration
-    static size_t maxAllowedThreads = getMaxAllowedThreads();
-    ClientConfig const& currConfig = Options::get().getDynamicOptions().getCurrentConfig();
-    if (currConfigId != currConfig.getId().id())
+    std::unique_lock<std::mutex> lock(g_poolMutex);
+    configLimits[configId.id()] = allowedThreads;
+
+    // Keep the queue short, so the progress output follows the execution
+    g_doneCv.wait(lock, []() { return taskQueue.size() < workers.size(); });
+    taskQueue.push_back(Task{wrappedJob, configId.id()});
+    g_pendingTasks++;
+    g_poolCv.notify_one();
+}
+
+void ThreadManager::joinThreads()
+{
+    if (!workers.empty())
     {
-        currConfigId = currConfig.getId().id();
-        maxAllowedThreads = getMaxAllowedThreads();
+        {
+            std::unique_lock<std::mutex> lock(g_poolMutex);
+            g_doneCv.wait(lock, []() { return g_pendingTasks == 0; });
+        }
+        stopPool();
     }
 
-    // Wait for at least one connection to finish it's task
-    if (threadMap.size() == maxAllowedThreads)
+    if (ExitHandler::receivedExitSignal())
     {
-        waitForAtLeastOneJobToFinish();
-        joinThreads(false);
+        // if one of the tests threads failed with fatal exception stop retesteth execution
+        ExitHandler::doExit();
     }
+    // otherwise continue test execution
 }
 
-void ThreadManager::joinThreads(bool _all)
+bool ThreadManager::configHasSlot(unsigned _configId)
 {
-    if (_all)
+    size_t const limit = configLimits.count(_configId) ? configLimits.at(_configId) : 1;
+    return configWorkers[_configId] < limit;
+}
+
+bool ThreadManager::takeJob(size_t _workerID, std::function<void()>& _job)
+{
+    // Own units first, then steal units of the other workers
+    // Units are taken before new tasks as the worker that split the task waits for them
+    // A job is taken only if its config has less running workers than allowed
+    Worker& own = *workers.at(_workerID);
+    auto assign = [&own](unsigned _configId) {
+        own.configId = _configId;
+        configWorkers[_configId]++;
+        return true;
+    };
+    if (!own.units.empty())
     {
-        for (auto& th : threadMap)
+        _job = std::move(own.units.back());
+        own.units.pop_back();
+        return assign(own.configId);
+    }
+    for (auto& worker : workers)
+    {
+        if (!worker->units.empty() && configHasSlot(worker->configId))
         {
-            th.second.join();
-            // A thread with exception thrown still being joined here!
-            RPCSession::sessionEnd(th.first, RPCSession::SessionStatus::Available);
+            _job = std::move(worker->units.front());
+            worker->units.pop_front();
+            return assign(worker->configId);
         }
-        threadMap.clear();
-        if (ExitHandler::receivedExitSignal())
+    }
+    for (auto it = taskQueue.begin(); it != taskQueue.end(); it++)
+    {
+        if (configHasSlot(it->configId))
         {
-            // if one of the tests threads failed with fatal exception stop retesteth execution
-            ExitHandler::doExit();
+            unsigned const configId = it->configId;
+            _job = std::move(it->job);
+            taskQueue.erase(it);
+            g_doneCv.notify_all();  // addTask waits for the queue space
+            return assign(configId);
         }
-        // otherwise continue test execution
-        return;
     }
+    return false;
+}
 
-    bool finished = false;
-    while (!finished)
+void ThreadManager::workerLoop(size_t _workerID)
+{
+    t_workerID = (int)_workerID;
+    while (true)
     {
-        for (std::map<thread::id, thread>::iterator it = threadMap.begin(); it != threadMap.end(); it++)
+        std::function<void()> job;
         {
-            auto status = RPCSession::sessionStatus(it->first);
-            if (status == RPCSession::HasFinished)
-            {
-                thread::id const& id = it->first;
-                it->second.join();
-                RPCSession::sessionEnd(id, RPCSession::SessionStatus::Available);
-                threadMap.erase(it);
-                return;
-            }
-            else if (status == RPCSession::NotExist && ExitHandler::receivedExitSignal())
+            std::unique_lock<std::mutex> lock(g_poolMutex);
+            g_idleWorkers++;
+            g_poolCv.wait(lock, [_workerID, &job]() { return takeJob(_workerID, job) || g_stopPool; });
+            g_idleWorkers--;
+            if (!job)
                 return;
         }
+        job();
 
-        // The session availability check is time consuming. Let other threads to work
-        if (Options::get().threadCount > 1)
-            std::this_thread::sleep_for(25ms);
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        configWorkers[workers.at(_workerID)->configId]--;
+        g_poolCv.notify_one();  // a job of this config could be taken again
     }
 }
 
-void ThreadManager::waitForAtLeastOneJobToFinish()
+bool ThreadManager::canSplitTasks()
 {
-    std::unique_lock<std::mutex> lkj(g_jobsmutex);
-    if (g_activejobs != 0)
+    if (t_workerID < 0)
+        return false;
+    std::lock_guard<std::mutex> lock(g_poolMutex);
+    return taskQueue.empty() && g_idleWorkers > 0 && configHasSlot(workers.at(t_workerID)->configId);
+}
+
+void ThreadManager::runUnits(std::vector<std::function<void()>> const& _units)
+{
+    std::vector<std::exception_ptr> errors(_units.size());
+    if (t_workerID < 0)
     {
-        lkj.unlock();
-        std::unique_lock<std::mutex> lk(g_callbackmutex);
-        g_cv.wait(lk);
+        for (size_t i = 0; i < _units.size() && !ExitHandler::receivedExitSignal(); i++)
+        {
+            try
+            {
+                _units.at(i)();
+            }
+            catch (...)
+            {
+                errors.at(i) = std::current_exception();
+            }
+        }
     }
     else
-        lkj.unlock();
+    {
+        // Stolen unit reports errors under the same test name and runs with the same config
+        int const ownerID = t_workerID;
+        test::ClientConfigID const configId = Options::getDynamicOptions().getCurrentConfig().getId();
+        boost::filesystem::path const testFile = TestOutputHelper::get().testFile();
+        string const testName = TestOutputHelper::get().testName();
+        size_t remaining = _units.size();
+
+        std::unique_lock<std::mutex> lock(g_poolMutex);
+        Worker& owner = *workers.at(ownerID);
+        for (size_t i = _units.size(); i > 0; i--)
+        {
+            size_t const unitID = i - 1;
+            owner.units.push_back([&_units, &errors, &remaining, &testFile, &testName, &configId, ownerID, unitID]() {
+                thread::id const id = TestOutputHelper::getThreadID();
+                bool const stolen = t_workerID != ownerID;
+                if (stolen)
+                {
+                    Options::getDynamicOptions().setThreadConfig(configId);
+                    TestOutputHelper::get().setCurrentTestFile(testFile);
+                    TestOutputHelper::get().setCurrentTestName(testName);
+                    RPCSession::sessionStart(id);
+                }
+                try
+                {
+                    if (!ExitHandler::receivedExitSignal())
+                        _units.at(unitID)();
+                }
+                catch (...)
+                {
+                    errors.at(unitID) = std::current_exception();
+                }
+                if (stolen)
+                    RPCSession::sessionEnd(id, RPCSession::SessionStatus::HasFinished);
+
+                std::lock_guard<std::mutex> lock(g_poolMutex);
+                remaining--;
+                g_doneCv.notify_all();
+            });
+            g_poolCv.notify_one();
+        }
+
+        // Execute own units, then wait for the stolen ones
+        while (!owner.units.empty())
+        {
+            std::function<void()> unit = std::move(owner.units.back());
+            owner.units.pop_back();
+            lock.unlock();
+            unit();
+            lock.lock();
+        }
+        g_doneCv.wait(lock, [&remaining]() { return remaining == 0; });
+    }
+
+    for (auto const& error : errors)
+        if (error)
+            std::rethrow_exception(error);
 }
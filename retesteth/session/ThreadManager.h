@@ -1,20 +1,60 @@
 #pragma once
 #include <stdio.h>
+#include <deque>
+#include <functional>
 #include <map>
+#include <memory>
+#include <set>
 #include <thread>
-#include <functional>
+#include <vector>
 
-// Manages jobs ensuring that only as many as -j flag allows are currently running
-// Construct over the Session class which manages new connections to the clients
+// Fixed pool of workers, as many as -j flag allows. Each worker keeps its client session
+// (the Session class manages the connections) until the pool is stopped in joinThreads
+// Tasks are taken from the common queue. Units of a running task are pushed to the deque
+// of its worker, idle workers take them from the other end of the deque
+// The task queue and all deques are one shared queue guarded by a single mutex, jobs are test
+// files and their units that take milliseconds, so the lock is not contended
+// Tasks of different client configs could be queued at the same time. Each task runs with the config
+// it was added with, the number of workers running one config is limited by the config socket type
 class ThreadManager
 {
 public:
-    static void joinThreads(bool _all = true);
+    static void joinThreads();
     static void addTask(std::function<void()> _job);
+
+    // True if called from a worker while the task queue is empty and some workers are idle
+    // Then the running task could split its work with runUnits()
+    static bool canSplitTasks();
+
+    // Execute independent units of a task. The calling worker executes the units from its deque
+    // while idle workers steal them. Exceptions of the units are rethrown in the unit order
+    // after all units are finished
+    static void runUnits(std::vector<std::function<void()>> const& _units);
+
 private:
+    struct Worker
+    {
+        std::thread thread;
+        std::deque<std::function<void()>> units;
+        unsigned configId = 0;  // config of the running job
+    };
+
+    struct Task
+    {
+        std::function<void()> job;
+        unsigned configId;
+    };
+
     ThreadManager() {}
-    static void waitForAtLeastOneJobToFinish();
+    static void startPool();
+    static void stopPool();
+    static void workerLoop(size_t _workerID);
+    static bool takeJob(size_t _workerID, std::function<void()>& _job);
+    static bool configHasSlot(unsigned _configId);
     static size_t getMaxAllowedThreads();
-    static std::map<std::thread::id, std::thread> threadMap;
-    static unsigned int currConfigId;
+    static std::vector<std::unique_ptr<Worker>> workers;
+    static std::deque<Task> taskQueue;
+    static std::map<unsigned, size_t> configLimits;   // max workers of the config
+    static std::map<unsigned, size_t> configWorkers;  // workers running the config
+    static std::set<unsigned> warnedConfigs;
 };
@@ -0,0 +1,118 @@
+#include "GenesisCache.h"
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+
+using namespace std;
+using namespace test;
+
+namespace
+{
+std::mutex g_genesisCacheMutex;
+std::map<string, string> g_genesisCache;
+std::set<string> g_genesisCacheLoadedFiles;
+
+// Tool identity is calculated again when the tool file changes
+struct ToolIdentity
+{
+    std::time_t mtime;
+    uintmax_t size;
+    string id;
+};
+std::mutex g_toolIdentityMutex;
+std::map<string, ToolIdentity> g_toolIdentities;
+
+fs::path genesisCacheFile()
+{
+    return Options::getCurrentConfig().cfgFile().path().parent_path() / "genesis.cache";
+}
+
+// Read `key stateRoot` lines stored by previous runs
+void loadGenesisCache()
+{
+    if (!Options::get().cachegenesis)
+        return;
+    fs::path const cacheFile = genesisCacheFile();
+    if (g_genesisCacheLoadedFiles.count(cacheFile.string()))
+        return;
+    g_genesisCacheLoadedFiles.insert(cacheFile.string());
+    if (!fs::exists(cacheFile))
+        return;
+    for (auto const& line : test::explode(dev::contentsString(cacheFile), '\n'))
+    {
+        auto const pair = test::explode(line, ' ');
+        if (pair.size() == 2 && pair.at(0).size() == 66 && pair.at(1).size() == 66)
+            g_genesisCache[pair.at(0)] = pair.at(1);
+    }
+    ETH_LOG("Genesis cache loaded " + fto_string(g_genesisCache.size()) + " records from " + cacheFile.string(), 6);
+}
+}  // namespace
+
+namespace toolimpl
+{
+string toolIdentity(fs::path const& _toolPath)
+{
+    boost::system::error_code ec;
+    std::time_t const mtime = fs::last_write_time(_toolPath, ec);
+    uintmax_t const size = ec ? 0 : fs::file_size(_toolPath, ec);
+    if (ec)
+        return _toolPath.string();
+
+    std::lock_guard<std::mutex> lock(g_toolIdentityMutex);
+    auto const it = g_toolIdentities.find(_toolPath.string());
+    if (it != g_toolIdentities.end() && it->second.mtime == mtime && it->second.size == size)
+        return it->second.id;
+
+    // Tool scripts often call the binary, so the version reported by the tool is a part of the identity
+    string version;
+    try
+    {
+        version = test::executeCmd(_toolPath.string() + " -v", ExecCMDWarning::NoWarning);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_WARNING("Genesis cache could not get the version of " + _toolPath.string() + ": " + _ex.what());
+    }
+    string const id = _toolPath.string() + " " + fto_string(mtime) + " " + fto_string(size) + " " + version;
+    g_toolIdentities[_toolPath.string()] = {mtime, size, id};
+    return id;
+}
+
+FH32 genesisCacheKey(fs::path const& _toolPath, FORK const& _fork, EthereumBlockState const& _genesis)
+{
+    string key = toolIdentity(_toolPath) + _fork.asString();
+    key += _genesis.state()->asDataObject()->asJson(0, false, true);
+    key += _genesis.header()->asDataObject()->asJson(0, false, true);
+    return FH32("0x" + dev::toString(dev::sha3(key)));
+}
+
+spFH32 findGenesisStateRoot(FH32 const& _key)
+{
+    std::lock_guard<std::mutex> lock(g_genesisCacheMutex);
+    loadGenesisCache();
+    auto const it = g_genesisCache.find(_key.asString());
+    if (it == g_genesisCache.end())
+        return spFH32(0);
+    return spFH32(new FH32(it->second));
+}
+
+void cacheGenesisStateRoot(FH32 const& _key, FH32 const& _stateRoot)
+{
+    std::lock_guard<std::mutex> lock(g_genesisCacheMutex);
+    if (g_genesisCache.count(_key.asString()))
+        return;
+    g_genesisCache[_key.asString()] = _stateRoot.asString();
+    if (Options::get().cachegenesis)
+    {
+        std::ofstream out(genesisCacheFile().string(), std::ios::app);
+        out << _key.asString() << " " << _stateRoot.asString() << "\n";
+    }
+}
+
+}  // namespace toolimpl
@@ -0,0 +1,18 @@
+#pragma once
+#include <retesteth/testStructures/types/Ethereum/EthereumBlock.h>
+#include <boost/filesystem.hpp>
+namespace fs = boost::filesystem;
+
+namespace toolimpl
+{
+// Genesis stateRoot cache shared between all tool sessions
+// The genesis with the same (tool, fork, alloc, env) is calculated by the tool only once per run
+// With --cachegenesis the cache is stored in the client config folder and reused between runs
+// The key includes the tool identity: path, mtime and size of the tool file and the `tool -v` output
+// so the records of an upgraded tool are not used
+FH32 genesisCacheKey(fs::path const& _toolPath, FORK const& _fork, EthereumBlockState const& _genesis);
+spFH32 findGenesisStateRoot(FH32 const& _key);
+void cacheGenesisStateRoot(FH32 const& _key, FH32 const& _stateRoot);
+std::string toolIdentity(fs::path const& _toolPath);
+
+}  // namespace toolimpl
@@ -1,3 +1,4 @@
+#include "GenesisCache.h"
 #include "ToolChainHelper.h"
 #include "ToolChainManager.h"
 #include <Options.h>
@@ -15,13 +16,14 @@ using namespace dataobject;
 
 namespace toolimpl
 {
-ToolChain::ToolChain(
-    EthereumBlockState const& _genesis, spSetChainParamsArgs const& _config, fs::path const& _toolPath, fs::path const& _tmpDir)
+ToolChain::ToolChain(EthereumBlockState const& _genesis, spSetChainParamsArgs const& _config, fs::path const& _toolPath,
+    fs::path const& _tmpDir, spToolServer const& _toolServer)
   : m_initialParams(_config),
     m_engine(_config->sealEngine()),
     m_fork(new FORK(_config->params().atKey("fork"))),
     m_toolPath(_toolPath),
-    m_tmpDir(_tmpDir)
+    m_tmpDir(_tmpDir),
+    m_toolServer(_toolServer)
 {
     m_toolParams = GCP_SPointer<ToolParams>(new ToolParams(_config->params()));
 
@@ -36,11 +38,29 @@ ToolChain::ToolChain(
         throw test::UpwardsException("Constructing legacy genesis on network which is higher London!");
     }
 
-    // We yet don't know the state root. ask the tool to calculate it
-    ToolResponse res = mineBlockOnTool(_genesis, _genesis, SealEngine::NoReward);
+    // We yet don't know the state root. Calculate the state trie without the tool
+    spFH32 genesisStateRoot;
+    try
+    {
+        genesisStateRoot = spFH32(new FH32(calculateStateRoot(_genesis.state())));
+    }
+    catch (std::exception const& _ex)
+    {
+        // State values that do not fit the trie encoding. Ask the tool to calculate it
+        // Same genesis is often requested for every transaction of the state test, so cache the result
+        ETH_LOG(string("Genesis stateRoot is calculated by the tool: ") + _ex.what(), 6);
+        FH32 const cacheKey = genesisCacheKey(m_toolPath, m_fork, _genesis);
+        genesisStateRoot = findGenesisStateRoot(cacheKey);
+        if (genesisStateRoot.isEmpty())
+        {
+            ToolResponse res = mineBlockOnTool(_genesis, _genesis, SealEngine::NoReward);
+            genesisStateRoot = spFH32(new FH32(res.stateRoot()));
+            cacheGenesisStateRoot(cacheKey, genesisStateRoot);
+        }
+    }
 
     EthereumBlockState genesisFixed(_genesis.header(), _genesis.state(), FH32::zero());
-    genesisFixed.headerUnsafe().getContent().setStateRoot(res.stateRoot());
+    genesisFixed.headerUnsafe().getContent().setStateRoot(genesisStateRoot);
     genesisFixed.headerUnsafe().getContent().recalculateHash();
     genesisFixed.setTotalDifficulty(genesisFixed.header()->difficulty());
     m_blocks.push_back(genesisFixed);
@@ -48,12 +68,13 @@ ToolChain::ToolChain(
 
 ToolChain::ToolChain(
     EthereumBlockState const& _blockA, EthereumBlockState const& _blockB,
-    FORK const& _fork, fs::path const& _toolPath, fs::path const& _tmpDir)
+    FORK const& _fork, fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer)
   : m_initialParams(0),
     m_engine(SealEngine::NoProof),
     m_fork(new FORK(_fork.asString())),
     m_toolPath(_toolPath),
-    m_tmpDir(_tmpDir)
+    m_tmpDir(_tmpDir),
+    m_toolServer(_toolServer)
 {
     // Constructor to execute t8n given 2 blocks to calculate the difficulty transition
     ToolResponse res = mineBlockOnTool(_blockB, _blockA, SealEngine::NoReward);
@@ -64,10 +85,19 @@ ToolChain::ToolChain(
 spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock, EthereumBlockState const& _parentBlock, Mining _req)
 {
     ToolResponse const res = mineBlockOnTool(_pendingBlock, _parentBlock, m_engine);
+    return mineBlock(_pendingBlock, res, _req);
+}
 
+std::vector<ToolResponse> ToolChain::mineBlocksOnTool(std::vector<EthereumBlockState> const& _pendingBlocks)
+{
+    return mineBlocksOnTool(_pendingBlocks, lastBlock(), m_engine);
+}
+
+spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock, ToolResponse const& _res, Mining _req)
+{
     // Pending fixed is pending header corrected by the information returned by tool
     // The tool can reject transactions changing the stateHash, TxRoot, TxReceipts, HeaderHash, GasUsed
-    EthereumBlockState pendingFixed(_pendingBlock.header(), res.state(), res.logsHash());
+    EthereumBlockState pendingFixed(_pendingBlock.header(), _res.state(), _res.logsHash());
 
     // Construct a block header with information that we have and what we get from t8ntool
     // The block number is current max block + 1
@@ -75,19 +105,19 @@ spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock,
     pendingFixedHeader.setNumber(m_blocks.size());
 
     // Tool calculated transactions and state
-    pendingFixedHeader.setStateRoot(res.stateRoot());         // Assign StateHash from the tool
-    pendingFixedHeader.setGasUsed(res.totalGasUsed());        // Assign GasUsed from the tool
-    pendingFixedHeader.setTransactionHash(res.txRoot());      // Assign TxRoot from the tool
-    pendingFixedHeader.setTrReceiptsHash(res.receiptRoot());  // Assign TxReceipt from the tool
-    pendingFixedHeader.setLogsBloom(res.logsBloom());         // Assign LogsBloom from the
-    pendingFixedHeader.setStateRoot(res.stateRoot());         // Assign StateHash from the tool
+    pendingFixedHeader.setStateRoot(_res.stateRoot());         // Assign StateHash from the tool
+    pendingFixedHeader.setGasUsed(_res.totalGasUsed());        // Assign GasUsed from the tool
+    pendingFixedHeader.setTransactionHash(_res.txRoot());      // Assign TxRoot from the tool
+    pendingFixedHeader.setTrReceiptsHash(_res.receiptRoot());  // Assign TxReceipt from the tool
+    pendingFixedHeader.setLogsBloom(_res.logsBloom());         // Assign LogsBloom from the
+    pendingFixedHeader.setStateRoot(_res.stateRoot());         // Assign StateHash from the tool
 
     // Calculate difficulty for tool (tool does not calculate difficulty)
     ChainOperationParams params = ChainOperationParams::defaultParams(toolParams());
     VALUE toolDifficulty = calculateEthashDifficulty(params, pendingFixed.header(), lastBlock().header());
-    pendingFixedHeader.setDifficulty(res.currentDifficulty());
-    if (toolDifficulty != res.currentDifficulty())
-        ETH_ERROR_MESSAGE("tool vs retesteth difficulty disagree: " + res.currentDifficulty().asDecString() + " vs " + toolDifficulty.asDecString());
+    pendingFixedHeader.setDifficulty(_res.currentDifficulty());
+    if (toolDifficulty != _res.currentDifficulty())
+        ETH_ERROR_MESSAGE("tool vs retesteth difficulty disagree: " + _res.currentDifficulty().asDecString() + " vs " + toolDifficulty.asDecString());
 
     // Calculate new baseFee
     if (pendingFixedHeader.type() == BlockType::BlockHeader1559 &&
@@ -108,7 +138,7 @@ spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock,
     {
         bool found = false;
         FH32 const trHash = tr->hash();
-        for (auto const& trReceipt : res.receipts())
+        for (auto const& trReceipt : _res.receipts())
         {
             if (trReceipt.trHash() == trHash)
             {
@@ -123,7 +153,7 @@ spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock,
 
             // Find the rejected transaction information
             bool rejectedInfoFound = false;
-            for (auto const& el : res.rejected())
+            for (auto const& el : _res.rejected())
             {
                 if (el.index() == index)
                 {
@@ -175,6 +205,9 @@ spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock,
 
     if (_req == Mining::RequireValid)  // called on rawRLP import
     {
+        // Mined blocks are trusted, imported blocks are checked against the roots calculated by retesteth
+        verifyEthereumBlockRoots(pendingFixed);
+
         if (m_fork.getContent().asString() == "HomesteadToDaoAt5" && pendingFixed.header()->number() > 4 &&
             pendingFixed.header()->number() < 19 &&
             pendingFixed.header()->extraData().asString() != "0x64616f2d686172642d666f726b")
@@ -192,11 +225,11 @@ spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock,
         }
     }
 
-    if (pendingFixed.header()->transactionRoot() != res.txRoot())
+    if (pendingFixed.header()->transactionRoot() != _res.txRoot())
     {
         ETH_ERROR_MESSAGE(string("ToolChain::mineBlock txRootHash is different to one ruturned by tool \n") +
                           "constructedBlockHash: " + pendingFixed.header()->transactionRoot().asString() +
-                          "\n toolTransactionRoot: " + res.txRoot().asString());
+                          "\n toolTransactionRoot: " + _res.txRoot().asString());
     }
 
     VALUE totalDifficulty(0);
@@ -209,33 +242,36 @@ spDataObject const ToolChain::mineBlock(EthereumBlockState const& _pendingBlock,
                 pendingFixed.header()->difficulty().asDecString() + " = " +
                 pendingFixed.totalDifficulty().asDecString(), 6);
 
-    pendingFixed.setTrsTrace(res.debugTrace());
+    pendingFixed.setTrsTrace(_res.debugTrace());
     m_blocks.push_back(pendingFixed);
 
     return miningResult;
 }
 
-ToolResponse ToolChain::mineBlockOnTool(EthereumBlockState const& _block, EthereumBlockState const& _parent, SealEngine _engine)
+ToolChain::ToolInput ToolChain::prepareToolInput(
+    EthereumBlockState const& _block, EthereumBlockState const& _parent, SealEngine _engine) const
 {
+    ToolInput input;
+
     // env.json file
-    fs::path envPath = m_tmpDir / "env.json";
     auto spHeader = _block.header()->asDataObject();
     BlockchainTestFillerEnv env(dataobject::move(spHeader), m_engine);
-    spDataObject& envData = const_cast<spDataObject&>(env.asDataObject());
+    input.env = env.asDataObject();
+    DataObject& envData = input.env.getContent();
     if (_parent.header()->number() != _block.header()->number())
     {
         if (_parent.header()->hash() != _block.header()->parentHash())
             ETH_ERROR_MESSAGE("ToolChain::mineBlockOnTool: provided parent block != pending parent block hash!");
-        (*envData).removeKey("currentDifficulty");
-        (*envData)["parentTimestamp"] = _parent.header()->timestamp().asString();
-        (*envData)["parentDifficulty"] = _parent.header()->difficulty().asString();
-        (*envData)["parentUncleHash"] = _parent.header()->uncleHash().asString();
+        envData.removeKey("currentDifficulty");
+        envData["parentTimestamp"] = _parent.header()->timestamp().asString();
+        envData["parentDifficulty"] = _parent.header()->difficulty().asString();
+        envData["parentUncleHash"] = _parent.header()->uncleHash().asString();
     }
 
     // BlockHeader hash information for tool mining
     size_t k = 0;
     for (auto const& bl : m_blocks)
-        (*envData)["blockHashes"][fto_string(k++)] = bl.header()->hash().asString();
+        envData["blockHashes"][fto_string(k++)] = bl.header()->hash().asString();
     for (auto const& un : _block.uncles())
     {
         spDataObject uncle;
@@ -244,33 +280,24 @@ ToolResponse ToolChain::mineBlockOnTool(EthereumBlockState const& _block, Ethere
             throw test::UpwardsException("Uncle header delta is < 1");
         (*uncle)["delta"] = delta;
         (*uncle)["address"] = un->author().asString();
-        (*envData)["ommers"].addArrayObject(uncle);
+        envData["ommers"].addArrayObject(uncle);
     }
 
     // Options Hook
-    Options::getCurrentConfig().performFieldReplace(envData.getContent(), FieldReplaceDir::RetestethToClient);
-
-    string const envPathContent = envData->asJson();
-    writeFile(envPath.string(), envPathContent);
+    Options::getCurrentConfig().performFieldReplace(envData, FieldReplaceDir::RetestethToClient);
 
     // alloc.json file
-    fs::path allocPath = m_tmpDir / "alloc.json";
-    string const allocPathContent = _block.state()->asDataObject()->asJsonNoFirstKey();
-    writeFile(allocPath.string(), allocPathContent);
+    input.alloc = _block.state();
 
     // txs.json file
     bool exportRLP = true;
-    string const txsfile = _block.transactions().size() && exportRLP ? "txs.rlp" : "txs.json";
-    fs::path txsPath = m_tmpDir / txsfile;
-
-    string txsPathContent;
+    input.txsFile = _block.transactions().size() && exportRLP ? "txs.rlp" : "txs.json";
     if (exportRLP)
     {
         dev::RLPStream txsout(_block.transactions().size());
         for (auto const& tr : _block.transactions())
             txsout.appendRaw(tr->asRLPStream().out());
-        txsPathContent = _block.transactions().size() ? "\"" + dev::toString(txsout.out()) + "\"" : "[]";
-        writeFile(txsPath.string(), txsPathContent);
+        input.txs = _block.transactions().size() ? "\"" + dev::toString(txsout.out()) + "\"" : "[]";
     }
     else
     {
@@ -285,103 +312,245 @@ ToolResponse ToolChain::mineBlockOnTool(EthereumBlockState const& _block, Ethere
                     "Retesteth rejecting tx with gasLimit > 64 bits for tool" + TestOutputHelper::get().testInfo().errorDebug());
         }
         Options::getCurrentConfig().performFieldReplace(txs, FieldReplaceDir::RetestethToClient);
-        txsPathContent = txs.asJson();
-        writeFile(txsPath.string(), txsPathContent);
+        input.txs = txs.asJson();
     }
 
-    // output file
-    fs::path outPath = m_tmpDir / "out.json";
-    fs::path outAllocPath = m_tmpDir / "outAlloc.json";
-
-
-    string cmd = m_toolPath.string();
+    string forkName = m_fork->asString();
+    string reward;
     if (_engine != SealEngine::NoReward)
     {
         // Convert FrontierToHomesteadAt5 -> Homestead if block > 5, and get reward
-        auto tupleRewardFork = prepareReward(_engine, m_fork.getContent(), _block.header()->number());
-        cmd += " --state.fork " + std::get<1>(tupleRewardFork).asString();
-        cmd += " --state.reward " + std::get<0>(tupleRewardFork).asDecString();
+        auto tupleRewardFork = prepareReward(_engine, m_fork.getCContent(), _block.header()->number());
+        forkName = std::get<1>(tupleRewardFork).asString();
+        reward = std::get<0>(tupleRewardFork).asDecString();
     }
-    else
-        cmd += " --state.fork " + m_fork->asString();
-
-    cmd += " --input.alloc " + allocPath.string();
-    cmd += " --input.txs " + txsPath.string();
-    cmd += " --input.env " + envPath.string();
-    cmd += " --output.basedir " + m_tmpDir.string();
-    cmd += " --output.result " + outPath.filename().string();
-    cmd += " --output.alloc " + outAllocPath.filename().string();
+    input.args = " --state.fork " + forkName;
+    if (!reward.empty())
+        input.args += " --state.reward " + reward;
 
-    bool traceCondition = Options::get().vmtrace && _block.header()->number() != 0;
-    if (traceCondition)
+    input.trace = Options::get().vmtrace && _block.header()->number() != 0;
+    if (input.trace)
     {
-        cmd += " --trace ";
+        input.traceArgs += " --trace ";
         if (!Options::get().vmtrace_nomemory)
-            cmd += "--trace.memory ";
+            input.traceArgs += "--trace.memory ";
         if (!Options::get().vmtrace_noreturndata)
-            cmd += "--trace.returndata ";
+            input.traceArgs += "--trace.returndata ";
         if (Options::get().vmtrace_nostack)
-            cmd += "--trace.nostack ";
+            input.traceArgs += "--trace.nostack ";
     }
 
-    ETH_TEST_MESSAGE("Alloc:\n" + allocPathContent);
+    ETH_TEST_MESSAGE("Alloc:\n" + _block.state()->asDataObject()->asJsonNoFirstKey());
     if (_block.transactions().size())
     {
-        ETH_TEST_MESSAGE("Txs:\n" + txsPathContent);
+        ETH_TEST_MESSAGE("Txs:\n" + input.txs);
         for (auto const& tr : _block.transactions())
             ETH_TEST_MESSAGE(tr->asDataObject()->asJson());
     }
-    ETH_TEST_MESSAGE("Env:\n" + envPathContent);
+    ETH_TEST_MESSAGE("Env:\n" + input.env->asJson());
+    return input;
+}
+
+bool ToolChain::requestToolServer(ToolInput const& _input, fs::path const& _basedir, ToolOutput& _output)
+{
+    if (m_toolServer.isEmpty() || !m_toolServer->isRunning())
+        return false;
 
-    string out = test::executeCmd(cmd, ExecCMDWarning::NoWarning);
+    // Same arguments as for the cmd run, but the input files are streamed with the request
+    string const args = _input.args + " --output.basedir " + _basedir.string() + _input.traceArgs;
+    try
+    {
+        spDataObject const response =
+            m_toolServer.getContent().requestT8n(args, _input.alloc->asDataObject(), _input.env, _input.txs);
+        ETH_TEST_MESSAGE("Res:\n" + response->atKey("result").asJson());
+        ETH_TEST_MESSAGE("RAlloc:\n" + response->atKey("alloc").asJson());
+        _output.result = response->atKey("result").copy();
+        _output.alloc = response->atKey("alloc").copy();
+        return true;
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_WARNING(string("Tool server mode failed, falling back to file mode: ") + _ex.what());
+    }
+    return false;
+}
 
-    string const outPathContent = contentsString(outPath.string());
-    string const outAllocPathContent = contentsString(outAllocPath.string());
-    ETH_TEST_MESSAGE("Res:\n" + outPathContent);
-    ETH_TEST_MESSAGE("RAlloc:\n" + outAllocPathContent);
-    ETH_TEST_MESSAGE(cmd);
-    ETH_TEST_MESSAGE(out);
+void ToolChain::executeToolFiles(
+    std::vector<ToolInput const*> const& _jobs, std::vector<fs::path> const& _basedirs, std::vector<ToolOutput>& _outputs)
+{
+    // Jobs share the env.json and alloc.json files. Each job has own txs and output files in its basedir
+    // The tool takes one txs file per run, so the jobs are executed one after another
+    assert(_jobs.size() == _basedirs.size() && _jobs.size() > 0);
+    fs::path const envPath = m_tmpDir / "env.json";
+    fs::path const allocPath = m_tmpDir / "alloc.json";
+    writeFile(envPath.string(), _jobs.at(0)->env->asJson());
+    writeFile(allocPath.string(), _jobs.at(0)->alloc->asDataObject()->asJsonNoFirstKey());
+
+    _outputs.clear();
+    for (size_t i = 0; i < _jobs.size(); i++)
+    {
+        ToolInput const& input = *_jobs.at(i);
+        fs::path const& basedir = _basedirs.at(i);
+        if (basedir != m_tmpDir)
+            fs::create_directories(basedir);
+        fs::path const txsPath = basedir / input.txsFile;
+        fs::path const errPath = basedir / "stderr.txt";
+        writeFile(txsPath.string(), input.txs);
+
+        string cmd = m_toolPath.string();
+        cmd += input.args;
+        cmd += " --input.alloc " + allocPath.string();
+        cmd += " --input.txs " + txsPath.string();
+        cmd += " --input.env " + envPath.string();
+        cmd += " --output.basedir " + basedir.string();
+        cmd += " --output.result out.json";
+        cmd += " --output.alloc outAlloc.json";
+        cmd += input.traceArgs;
+
+        string out;
+        int const exitCode = test::executeCmd(cmd + " 2>" + errPath.string(), out);
+        string const err = contentsString(errPath.string());
+        fs::remove(errPath);
+        ETH_TEST_MESSAGE(cmd);
+        ETH_TEST_MESSAGE(out);
+        ETH_TEST_MESSAGE(err);
+        if (exitCode != 0)
+            ETH_ERROR_MESSAGE("The command '" + cmd + "' exited with " + toString(exitCode) + " code.\n" + err);
+
+        fs::path const outPath = basedir / "out.json";
+        fs::path const outAllocPath = basedir / "outAlloc.json";
+        string const outPathContent = contentsString(outPath.string());
+        string const outAllocPathContent = contentsString(outAllocPath.string());
+        ETH_TEST_MESSAGE("Res:\n" + outPathContent);
+        ETH_TEST_MESSAGE("RAlloc:\n" + outAllocPathContent);
+
+        if (outPathContent.empty())
+            ETH_ERROR_MESSAGE("Tool returned empty file: " + outPath.string() + "\n" + err);
+        if (outAllocPathContent.empty())
+            ETH_ERROR_MESSAGE("Tool returned empty file: " + outAllocPath.string() + "\n" + err);
+
+        ToolOutput output;
+        output.result = ConvertJsoncppStringToData(outPathContent);
+        output.alloc = ConvertJsoncppStringToData(outAllocPathContent);
+        _outputs.push_back(output);
+
+        fs::remove(txsPath);
+        fs::remove(outPath);
+        fs::remove(outAllocPath);
+    }
 
-    if (outPathContent.empty())
-        ETH_ERROR_MESSAGE("Tool returned empty file: " + outPath.string());
-    if (outAllocPathContent.empty())
-        ETH_ERROR_MESSAGE("Tool returned empty file: " + outAllocPath.string());
+    fs::remove(envPath);
+    fs::remove(allocPath);
+}
 
+ToolResponse ToolChain::makeToolResponse(
+    EthereumBlockState const& _block, ToolInput const& _input, fs::path const& _basedir, ToolOutput& _output) const
+{
     // Construct block rpc response
-    ToolResponse toolResponse(ConvertJsoncppStringToData(outPathContent));
-    spDataObject returnState = ConvertJsoncppStringToData(outAllocPathContent);
-    toolResponse.attachState(restoreFullState(returnState.getContent()));
+    ToolResponse toolResponse(_output.result);
+    toolResponse.attachState(restoreFullState(_output.alloc.getContent()));
 
-    if (traceCondition)
+    if (_input.trace)
     {
         size_t i = 0;
         for (auto const& tr : _block.transactions())
         {
             fs::path txTraceFile;
             string const trNumber = test::fto_string(i++);
-            txTraceFile = m_tmpDir / string("trace-" + trNumber + "-" + tr->hash().asString() + ".jsonl");
+            txTraceFile = _basedir / string("trace-" + trNumber + "-" + tr->hash().asString() + ".jsonl");
             if (fs::exists(txTraceFile))
             {
                 string const preinfo =
                     "\nTransaction number: " + trNumber + ", hash: " + tr->hash().asString() + "\n";
                 string const info = TestOutputHelper::get().testInfo().errorDebug();
                 string const traceinfo = "\nVMTrace:" + info + cDefault + preinfo;
-                toolResponse.attachDebugTrace(tr->hash(),
-                    DebugVMTrace(traceinfo, trNumber, tr->hash(), contentsString(txTraceFile)));
+                toolResponse.attachDebugTrace(tr->hash(), DebugVMTrace(traceinfo, trNumber, tr->hash(), txTraceFile));
+
+                // The trace stays mapped in memory. Unlink the file so the next tool run
+                // in the same basedir creates a new file instead of truncating the mapped one
+                fs::remove(txTraceFile);
             }
             else
                 ETH_LOG("Trace file `" + txTraceFile.string() + "` not found!", 1);
         }
     }
 
-    fs::remove(envPath);
-    fs::remove(allocPath);
-    fs::remove(txsPath);
-    fs::remove(outPath);
-    fs::remove(outAllocPath);
     return toolResponse;
 }
 
+ToolResponse ToolChain::mineBlockOnTool(EthereumBlockState const& _block, EthereumBlockState const& _parent, SealEngine _engine)
+{
+    ToolInput const input = prepareToolInput(_block, _parent, _engine);
+    std::vector<ToolOutput> outputs(1);
+    if (!requestToolServer(input, m_tmpDir, outputs.at(0)))
+        executeToolFiles({&input}, {m_tmpDir}, outputs);
+    return makeToolResponse(_block, input, m_tmpDir, outputs.at(0));
+}
+
+std::vector<ToolResponse> ToolChain::mineBlocksOnTool(
+    std::vector<EthereumBlockState> const& _blocks, EthereumBlockState const& _parent, SealEngine _engine)
+{
+    std::vector<ToolInput> inputs;
+    for (auto const& block : _blocks)
+        inputs.push_back(prepareToolInput(block, _parent, _engine));
+
+    // Jobs can share the tool run only when executed on the same env and alloc
+    bool sameInput = true;
+    for (auto const& input : inputs)
+    {
+        if (input.args != inputs.at(0).args || input.env->asJson(0, false) != inputs.at(0).env->asJson(0, false) ||
+            input.alloc->asDataObject()->asJson(0, false) != inputs.at(0).alloc->asDataObject()->asJson(0, false))
+        {
+            sameInput = false;
+            break;
+        }
+    }
+
+    std::vector<ToolResponse> responses;
+    if (!sameInput)
+    {
+        ETH_LOG("ToolChain::mineBlocksOnTool: jobs have different input, mining one by one", 6);
+        for (auto const& block : _blocks)
+            responses.push_back(mineBlockOnTool(block, _parent, _engine));
+        return responses;
+    }
+
+    std::vector<fs::path> basedirs;
+    for (size_t i = 0; i < inputs.size(); i++)
+        basedirs.push_back(m_tmpDir / ("job" + fto_string(i)));
+
+    // Long living tool process serves the jobs from memory, the rest run from the shared files
+    std::vector<ToolOutput> outputs(inputs.size());
+    std::vector<ToolInput const*> fileJobs;
+    std::vector<fs::path> fileBasedirs;
+    std::vector<size_t> fileJobsIndex;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        if (!requestToolServer(inputs.at(i), basedirs.at(i), outputs.at(i)))
+        {
+            fileJobs.push_back(&inputs.at(i));
+            fileBasedirs.push_back(basedirs.at(i));
+            fileJobsIndex.push_back(i);
+        }
+    }
+
+    if (fileJobs.size())
+    {
+        std::vector<ToolOutput> fileOutputs;
+        executeToolFiles(fileJobs, fileBasedirs, fileOutputs);
+        for (size_t i = 0; i < fileJobsIndex.size(); i++)
+            outputs.at(fileJobsIndex.at(i)) = fileOutputs.at(i);
+    }
+
+    for (size_t i = 0; i < _blocks.size(); i++)
+    {
+        responses.push_back(makeToolResponse(_blocks.at(i), inputs.at(i), basedirs.at(i), outputs.at(i)));
+        if (!inputs.at(i).trace)
+            fs::remove_all(basedirs.at(i));
+    }
+    return responses;
+}
+
 void ToolChain::rewindToBlock(size_t _number)
 {
     while (m_blocks.size() > _number + 1)
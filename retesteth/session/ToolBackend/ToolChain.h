@@ -1,4 +1,5 @@
 #pragma once
+#include "ToolServer.h"
 #include <testStructures/types/RPC/SetChainParamsArgs.h>
 #include <testStructures/types/RPC/ToolResponse.h>
 #include <testStructures/types/ethereum.h>
@@ -17,6 +18,10 @@ struct ToolParams : GCP_SPointerBase
     VALUE const& constantinopleForkBlock() const { return m_constantinopleForkBlock; }
     VALUE const& muirGlacierForkBlock() const { return m_muirGlacierForkBlock; }
     VALUE const& londonForkBlock() const { return m_londonForkBlock; }
+    VALUE const& arrowGlacierForkBlock() const { return m_arrowGlacierForkBlock; }
+
+    // Fork rules are known to retesteth, fork blocks that are not set in params are derived from the fork name
+    bool knownFork() const { return m_knownFork; }
 
 private:
     ToolParams();
@@ -25,6 +30,8 @@ private:
     spVALUE m_constantinopleForkBlock;
     spVALUE m_muirGlacierForkBlock;
     spVALUE m_londonForkBlock;
+    spVALUE m_arrowGlacierForkBlock;
+    bool m_knownFork;
 };
 
 // Manage test blockchains
@@ -32,11 +39,11 @@ class ToolChain : public GCP_SPointerBase
 {
 public:
     ToolChain(EthereumBlockState const& _genesis, spSetChainParamsArgs const& _params, fs::path const& _toolPath,
-        fs::path const& _tmpDir);
+        fs::path const& _tmpDir, spToolServer const& _toolServer);
 
     // Calculate difficulty from _blockA to _blockB constructor
     ToolChain(EthereumBlockState const& _blockA, EthereumBlockState const& _blockB, FORK const& _fork,
-        fs::path const& _toolPath, fs::path const& _tmpDir);
+        fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer);
 
     EthereumBlockState const& lastBlock() const
     {
@@ -57,17 +64,48 @@ public:
         AllowFailTransactions
     };
     spDataObject const mineBlock(EthereumBlockState const& _pendingBlock, EthereumBlockState const& _parentBlock, Mining _req = Mining::AllowFailTransactions);
+
+    // Execute the blocks on top of the last block, the tool input files are shared by the blocks
+    // Use mineBlock with the tool response to import each of them
+    std::vector<ToolResponse> mineBlocksOnTool(std::vector<EthereumBlockState> const& _pendingBlocks);
+    spDataObject const mineBlock(EthereumBlockState const& _pendingBlock, ToolResponse const& _res, Mining _req = Mining::AllowFailTransactions);
     void rewindToBlock(size_t _number);
 
     // Used for chain reorg
     void insertBlock(EthereumBlockState const& _block) { m_blocks.push_back(_block); }
     fs::path const& tmpDir() const { return m_tmpDir; }
+    spToolServer const& toolServer() const { return m_toolServer; }
 
 private:
     ToolChain(){};
     // Execute t8ntool cmd with input _block information, and get the output block information
     // Information includes header, transactions, state
     ToolResponse mineBlockOnTool(EthereumBlockState const& _block, EthereumBlockState const& _parent, SealEngine _engine = SealEngine::NoReward);
+    std::vector<ToolResponse> mineBlocksOnTool(
+        std::vector<EthereumBlockState> const& _blocks, EthereumBlockState const& _parent, SealEngine _engine);
+
+    // t8ntool input files content and arguments for a block
+    struct ToolInput
+    {
+        spDataObject env;
+        spState alloc;
+        string txs;
+        string txsFile;
+        string args;
+        string traceArgs;
+        bool trace = false;
+    };
+    struct ToolOutput
+    {
+        spDataObject result;
+        spDataObject alloc;
+    };
+    ToolInput prepareToolInput(EthereumBlockState const& _block, EthereumBlockState const& _parent, SealEngine _engine) const;
+    bool requestToolServer(ToolInput const& _input, fs::path const& _basedir, ToolOutput& _output);
+    void executeToolFiles(
+        std::vector<ToolInput const*> const& _jobs, std::vector<fs::path> const& _basedirs, std::vector<ToolOutput>& _outputs);
+    ToolResponse makeToolResponse(EthereumBlockState const& _block, ToolInput const& _input, fs::path const& _basedir,
+        ToolOutput& _output) const;
 
     GCP_SPointer<ToolParams> m_toolParams;
     const spSetChainParamsArgs m_initialParams;
@@ -76,6 +114,7 @@ private:
     spFORK m_fork;
     fs::path m_toolPath;
     fs::path m_tmpDir;
+    spToolServer m_toolServer;  // Empty if the tool runs in file mode
 };
 
 typedef GCP_SPointer<ToolChain> spToolChain;
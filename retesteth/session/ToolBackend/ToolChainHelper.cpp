@@ -3,6 +3,9 @@
 #include <retesteth/EthChecks.h>
 #include <retesteth/Options.h>
 #include <retesteth/testStructures/Common.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieHash.h>
+#include <thread>
 using namespace dev;
 using namespace test;
 using namespace teststruct;
@@ -10,6 +13,18 @@ using namespace dataobject;
 
 namespace toolimpl
 {
+namespace
+{
+// Fork block from params, or 0 if the fork rules include it from genesis
+spVALUE readForkBlock(DataObject const& _data, string const& _field, bool _activeAtGenesis)
+{
+    const bigint unreachable = 10000000000;
+    if (_data.count(_field))
+        return spVALUE(new VALUE(_data.atKey(_field)));
+    return spVALUE(new VALUE(_activeAtGenesis ? 0 : unreachable));
+}
+}  // namespace
+
 ToolParams::ToolParams(DataObject const& _data)
 {
     REQUIRE_JSONFIELDS(_data, "ToolParams " + _data.getKey(),
@@ -18,33 +33,47 @@ ToolParams::ToolParams(DataObject const& _data)
             {"constantinopleForkBlock", {{DataType::String}, jsonField::Optional}},
             {"byzantiumForkBlock", {{DataType::String}, jsonField::Optional}},
             {"londonForkBlock", {{DataType::String}, jsonField::Optional}},
+            {"arrowGlacierForkBlock", {{DataType::String}, jsonField::Optional}},
             {"homesteadForkBlock", {{DataType::String}, jsonField::Optional}}});
 
-    const bigint unreachable = 10000000000;
-    if (_data.count("homesteadForkBlock"))
-        m_homesteadForkBlock = spVALUE(new VALUE(_data.atKey("homesteadForkBlock")));
-    else
-        m_homesteadForkBlock = spVALUE(new VALUE(unreachable));
-
-    if (_data.count("byzantiumForkBlock"))
-        m_byzantiumForkBlock = spVALUE(new VALUE(_data.atKey("byzantiumForkBlock")));
-    else
-        m_byzantiumForkBlock = spVALUE(new VALUE(unreachable));
-
-    if (_data.count("constantinopleForkBlock"))
-        m_constantinopleForkBlock = spVALUE(new VALUE(_data.atKey("constantinopleForkBlock")));
-    else
-        m_constantinopleForkBlock = spVALUE(new VALUE(unreachable));
+    // Unknown forks have all the blocks unreachable unless set in params
+    ForkOrder const order = forkOrder(FORK(_data.atKey("fork").asString()));
+    m_knownFork = order != ForkOrder::Unknown;
+    auto const activeFrom = [this, order](ForkOrder _fork) { return m_knownFork && order >= _fork; };
 
-    if (_data.count("muirGlacierForkBlock"))
-        m_muirGlacierForkBlock = spVALUE(new VALUE(_data.atKey("muirGlacierForkBlock")));
-    else
-        m_muirGlacierForkBlock = spVALUE(new VALUE(unreachable));
+    m_homesteadForkBlock = readForkBlock(_data, "homesteadForkBlock", activeFrom(ForkOrder::Homestead));
+    m_byzantiumForkBlock = readForkBlock(_data, "byzantiumForkBlock", activeFrom(ForkOrder::Byzantium));
+    m_constantinopleForkBlock = readForkBlock(_data, "constantinopleForkBlock", activeFrom(ForkOrder::Constantinople));
+    m_muirGlacierForkBlock = readForkBlock(_data, "muirGlacierForkBlock", activeFrom(ForkOrder::MuirGlacier));
+    m_londonForkBlock = readForkBlock(_data, "londonForkBlock", activeFrom(ForkOrder::London));
+    m_arrowGlacierForkBlock = readForkBlock(_data, "arrowGlacierForkBlock", activeFrom(ForkOrder::ArrowGlacier));
+}
 
-    if (_data.count("londonForkBlock"))
-        m_londonForkBlock = spVALUE(new VALUE(_data.atKey("londonForkBlock")));
-    else
-        m_londonForkBlock = spVALUE(new VALUE(unreachable));
+ForkOrder forkOrder(FORK const& _fork)
+{
+    // Transition forks start with the rules of the first fork, the second fork block is set in params
+    static std::map<FORK, ForkOrder> const forks = {
+        {"Frontier", ForkOrder::Frontier},
+        {"FrontierToHomesteadAt5", ForkOrder::Frontier},
+        {"Homestead", ForkOrder::Homestead},
+        {"HomesteadToEIP150At5", ForkOrder::Homestead},
+        {"HomesteadToDaoAt5", ForkOrder::Homestead},
+        {"EIP150", ForkOrder::EIP150},
+        {"EIP158", ForkOrder::EIP158},
+        {"EIP158ToByzantiumAt5", ForkOrder::EIP158},
+        {"Byzantium", ForkOrder::Byzantium},
+        {"ByzantiumToConstantinopleFixAt5", ForkOrder::Byzantium},
+        {"Constantinople", ForkOrder::Constantinople},
+        {"ConstantinopleFix", ForkOrder::ConstantinopleFix},
+        {"Istanbul", ForkOrder::Istanbul},
+        {"MuirGlacier", ForkOrder::MuirGlacier},
+        {"Berlin", ForkOrder::Berlin},
+        {"BerlinToLondonAt5", ForkOrder::Berlin},
+        {"London", ForkOrder::London},
+        {"ArrowGlacier", ForkOrder::ArrowGlacier}
+    };
+    auto const it = forks.find(_fork);
+    return it == forks.end() ? ForkOrder::Unknown : it->second;
 }
 
 // We simulate the client backend side here, so thats why number5 is hardcoded
@@ -151,79 +180,124 @@ ChainOperationParams ChainOperationParams::defaultParams(ToolParams const& _para
     aleth.constantinopleForkBlock = _params.constantinopleForkBlock().asBigInt();
     aleth.muirGlacierForkBlock = _params.muirGlacierForkBlock().asBigInt();
     aleth.londonForkBlock = _params.londonForkBlock().asBigInt();
+    aleth.arrowGlacierForkBlock = _params.arrowGlacierForkBlock().asBigInt();
     return aleth;
 }
 
-// Aleth calculate difficulty formula
-VALUE calculateEthashDifficulty(
-    ChainOperationParams const& _chainParams, spBlockHeader const& _bi, spBlockHeader const& _parent)
+// Difficulty formula of the ethash forks up to ArrowGlacier
+// The minimum difficulty is applied before the difficulty bomb is added, same as geth
+bigint calculateEthashDifficulty(ChainOperationParams const& _chainParams, DifficultyArgs const& _args)
 {
     const unsigned c_expDiffPeriod = 100000;
 
-    if (_bi->number() == 0)
+    if (_args.number == 0)
         throw test::UpwardsException("calculateEthashDifficulty was called for block with number == 0");
 
-    auto const& minimumDifficulty = _chainParams.minimumDifficulty;
-    auto const& difficultyBoundDivisor = _chainParams.difficultyBoundDivisor;
-    auto const& durationLimit = _chainParams.durationLimit;
+    auto const& parentDifficulty = _args.parentDifficulty;
+    bigint const timestampDiff = _args.timestamp - _args.parentTimestamp;
 
-    VALUE target(0);  // stick to a bigint for the target. Don't want to risk going negative.
-    if (_bi->number() < _chainParams.homesteadForkBlock)
+    bigint target;  // stick to a bigint for the target. Don't want to risk going negative.
+    if (_args.number < _chainParams.homesteadForkBlock)
     {
         // Frontier-era difficulty adjustment
-        target = _bi->timestamp() >= _parent->timestamp() + durationLimit ?
-                     _parent->difficulty() - (_parent->difficulty() / difficultyBoundDivisor) :
-                     (_parent->difficulty() + (_parent->difficulty() / difficultyBoundDivisor));
+        bigint const delta = parentDifficulty / _chainParams.difficultyBoundDivisor;
+        target = timestampDiff >= _chainParams.durationLimit ? bigint(parentDifficulty - delta) :
+                                                               bigint(parentDifficulty + delta);
     }
     else
     {
-        VALUE const timestampDiff = _bi->timestamp() - _parent->timestamp();
-        VALUE const adjFactor =
-            _bi->number() < _chainParams.byzantiumForkBlock ?
-                max<bigint>(1 - timestampDiff.asBigInt() / 10, -99) :  // Homestead-era difficulty adjustment
-                max<bigint>((_parent->hasUncles() ? 2 : 1) - timestampDiff.asBigInt() / 9,
+        // Timestamp difference is rounded towards negative infinity
+        auto const floorDiv = [](bigint const& _a, bigint const& _b) {
+            return _a >= 0 ? bigint(_a / _b) : bigint(-((-_a + _b - 1) / _b));
+        };
+        bigint const adjFactor =
+            _args.number < _chainParams.byzantiumForkBlock ?
+                max<bigint>(1 - floorDiv(timestampDiff, 10), -99) :  // Homestead-era difficulty adjustment
+                max<bigint>((_args.parentHasUncles ? 2 : 1) - floorDiv(timestampDiff, 9),
                     -99);  // Byzantium-era difficulty adjustment
-
-        target = _parent->difficulty() + _parent->difficulty() / 2048 * adjFactor;
+        target = parentDifficulty + parentDifficulty / _chainParams.difficultyBoundDivisor * adjFactor;
     }
+    target = max<bigint>(_chainParams.minimumDifficulty, target);
 
-    VALUE o = target;
-    unsigned exponentialIceAgeBlockNumber = (unsigned)_parent->number().asBigInt() + 1;
+    bigint bombDelay = 0;
+    if (_args.number >= _chainParams.arrowGlacierForkBlock)
+        bombDelay = 10700000;  // EIP-4345 ArrowGlacier Difficulty Bomb Delay
+    else if (_args.number >= _chainParams.londonForkBlock)
+        bombDelay = 9700000;  // EIP-3554 London Difficulty Bomb Delay
+    else if (_args.number >= _chainParams.muirGlacierForkBlock)
+        bombDelay = 9000000;  // EIP-2384 Istanbul/Berlin Difficulty Bomb Delay
+    else if (_args.number >= _chainParams.constantinopleForkBlock)
+        bombDelay = 5000000;  // EIP-1234 Constantinople Ice Age delay
+    else if (_args.number >= _chainParams.byzantiumForkBlock)
+        bombDelay = 3000000;  // EIP-649 Byzantium Ice Age delay
 
-    // EIP-2384 Istanbul/Berlin Difficulty Bomb Delay
-    if (_bi->number().asBigInt() >= _chainParams.muirGlacierForkBlock)
-    {
-        if (exponentialIceAgeBlockNumber >= 9000000)
-            exponentialIceAgeBlockNumber -= 9000000;
-        else
-            exponentialIceAgeBlockNumber = 0;
-    }
-    // EIP-1234 Constantinople Ice Age delay
-    else if (_bi->number().asBigInt() >= _chainParams.constantinopleForkBlock)
-    {
-        if (exponentialIceAgeBlockNumber >= 5000000)
-            exponentialIceAgeBlockNumber -= 5000000;
-        else
-            exponentialIceAgeBlockNumber = 0;
-    }
-    // EIP-649 Byzantium Ice Age delay
-    else if (_bi->number().asBigInt() >= _chainParams.byzantiumForkBlock)
-    {
-        if (exponentialIceAgeBlockNumber >= 3000000)
-            exponentialIceAgeBlockNumber -= 3000000;
-        else
-            exponentialIceAgeBlockNumber = 0;
-    }
-
-    unsigned periodCount = exponentialIceAgeBlockNumber / c_expDiffPeriod;
+    bigint const exponentialIceAgeBlockNumber = max<bigint>(_args.number - bombDelay, 0);
+    bigint const periodCount = exponentialIceAgeBlockNumber / c_expDiffPeriod;
     // latter will eventually become huge, so ensure it's a bigint.
     if (periodCount > 1)
-        o += VALUE((bigint(1) << (periodCount - 2)));
+        target += bigint(1) << (unsigned)(periodCount - 2);
+    return target;
+}
 
-    o = max<bigint>(minimumDifficulty, o.asBigInt());
-    return o;  // bigint(min<bigint>(o, std::numeric_limits<bigint>::max()));
+VALUE calculateEthashDifficulty(
+    ChainOperationParams const& _chainParams, spBlockHeader const& _bi, spBlockHeader const& _parent)
+{
+    DifficultyArgs args;
+    args.number = _bi->number().asBigInt();
+    args.timestamp = _bi->timestamp().asBigInt();
+    args.parentTimestamp = _parent->timestamp().asBigInt();
+    args.parentDifficulty = _parent->difficulty().asBigInt();
+    args.parentHasUncles = _parent->hasUncles();
+    return VALUE(calculateEthashDifficulty(_chainParams, args));
 }
 
+std::vector<VALUE> calculateEthashDifficultyGrid(
+    ChainOperationParams const& _chainParams, std::vector<DifficultyArgs> const& _args, size_t _threads)
+{
+    std::vector<bigint> results(_args.size());
+    auto const calculateRange = [&_chainParams, &_args, &results](size_t _begin, size_t _end) {
+        for (size_t i = _begin; i < _end; i++)
+            results[i] = calculateEthashDifficulty(_chainParams, _args[i]);
+    };
+
+    // Threads are only worth it on big grids
+    size_t const c_minVectorsPerThread = 512;
+    size_t const threads = std::max<size_t>(1, std::min(_threads, _args.size() / c_minVectorsPerThread));
+    if (threads == 1)
+        calculateRange(0, _args.size());
+    else
+    {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(threads);
+        size_t const chunk = (_args.size() + threads - 1) / threads;
+        for (size_t t = 0; t < threads; t++)
+        {
+            size_t const begin = std::min(t * chunk, _args.size());
+            size_t const end = std::min(begin + chunk, _args.size());
+            workers.emplace_back([&calculateRange, &errors, t, begin, end]() {
+                try
+                {
+                    calculateRange(begin, end);
+                }
+                catch (...)
+                {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        for (auto const& error : errors)
+            if (error)
+                std::rethrow_exception(error);
+    }
+
+    std::vector<VALUE> values;
+    values.reserve(results.size());
+    for (auto const& res : results)
+        values.emplace_back(res);
+    return values;
+}
 
 VALUE calculateEIP1559BaseFee(ChainOperationParams const& _chainParams, spBlockHeader const& _bi, spBlockHeader const& _parent)
 {
@@ -258,4 +332,60 @@ VALUE calculateEIP1559BaseFee(ChainOperationParams const& _chainParams, spBlockH
     return expectedBaseFee;
 }
 
+namespace
+{
+u256 toU256(VALUE const& _value, string const& _what)
+{
+    if (_value.isBigInt() || _value.asBigInt() > dev::bigint(std::numeric_limits<u256>::max()))
+        throw test::UpwardsException("calculateStateRoot: " + _what + " is out of u256 range: " + _value.asString());
+    return u256(_value.asBigInt());
+}
+}  // namespace
+
+FH32 calculateStorageRoot(Storage const& _storage)
+{
+    BytesMap trie;
+    for (auto const& record : _storage.getKeys())
+    {
+        VALUE const& value = std::get<1>(record.second);
+        if (value.asBigInt() == 0)
+            continue;
+        h256 const key(toU256(std::get<0>(record.second), "storage key"));
+        trie[sha3(key).asBytes()] = rlp(toU256(value, "storage value"));
+    }
+    return FH32("0x" + toString(hash256(trie)));
+}
+
+FH32 calculateStateRoot(State const& _state)
+{
+    BytesMap trie;
+    for (auto const& el : _state.accounts())
+    {
+        AccountBase const& acc = el.second;
+        RLPStream account(4);
+        account << toU256(acc.nonce(), "nonce") << toU256(acc.balance(), "balance");
+        account << (acc.hasStorage() ? calculateStorageRoot(acc.storage()).serializeRLP() : EmptyTrie.asBytes());
+        account << sha3(acc.hasCode() ? fromHex(acc.code().asString()) : bytes());
+        trie[sha3(el.first.serializeRLP()).asBytes()] = account.out();
+    }
+    return FH32("0x" + toString(hash256(trie)));
+}
+
+FH32 calculateTransactionRoot(std::vector<spTransaction> const& _transactions)
+{
+    std::vector<bytes> trie;
+    trie.reserve(_transactions.size());
+    for (auto const& tr : _transactions)
+        trie.push_back(fromHex(tr->getRawBytes().asString()));
+    return FH32("0x" + toString(orderedTrieRoot(trie)));
+}
+
+FH32 calculateUncleHash(std::vector<spBlockHeader> const& _uncles)
+{
+    RLPStream uncleList(_uncles.size());
+    for (auto const& un : _uncles)
+        uncleList.appendRaw(un->asRLPStream().out());
+    return FH32("0x" + toString(sha3(uncleList.out())));
+}
+
 }  // namespace toolimpl
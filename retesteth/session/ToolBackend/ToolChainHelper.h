@@ -8,6 +8,25 @@ using namespace dev;
 namespace toolimpl
 {
 
+// Forks with rules known to retesteth in the order of activation
+enum class ForkOrder
+{
+    Frontier,
+    Homestead,
+    EIP150,
+    EIP158,
+    Byzantium,
+    Constantinople,
+    ConstantinopleFix,
+    Istanbul,
+    MuirGlacier,
+    Berlin,
+    London,
+    ArrowGlacier,
+    Unknown
+};
+ForkOrder forkOrder(FORK const& _fork);
+
 // Tool Logic
 struct ChainOperationParams
 {
@@ -20,12 +39,35 @@ struct ChainOperationParams
     bigint muirGlacierForkBlock;
     bigint constantinopleForkBlock;
     bigint londonForkBlock;
+    bigint arrowGlacierForkBlock;
 };
+
+// Parent and current block values that define the ethash difficulty
+struct DifficultyArgs
+{
+    bigint number;
+    bigint timestamp;
+    bigint parentTimestamp;
+    bigint parentDifficulty;
+    bool parentHasUncles;
+};
+
 std::tuple<VALUE, FORK> prepareReward(SealEngine _engine, FORK const& _fork, VALUE const& _blockNumber = VALUE(0));
 VALUE calculateGasLimit(VALUE const& _parentGasLimit, VALUE const& _parentGasUsed);
 VALUE calculateEthashDifficulty(
     ChainOperationParams const& _chainParams, spBlockHeader const& _bi, spBlockHeader const& _parent);
+bigint calculateEthashDifficulty(ChainOperationParams const& _chainParams, DifficultyArgs const& _args);
+
+// Calculate the difficulty for each of _args, the list is split between _threads worker threads
+std::vector<VALUE> calculateEthashDifficultyGrid(
+    ChainOperationParams const& _chainParams, std::vector<DifficultyArgs> const& _args, size_t _threads);
 VALUE calculateEIP1559BaseFee(ChainOperationParams const& _chainParams, spBlockHeader const& _bi, spBlockHeader const& _parent);
 State restoreFullState(DataObject& _toolState);
 
+// Merkle Patricia trie roots calculated without the tool
+FH32 calculateStorageRoot(Storage const& _storage);
+FH32 calculateStateRoot(State const& _state);
+FH32 calculateTransactionRoot(std::vector<spTransaction> const& _transactions);
+FH32 calculateUncleHash(std::vector<spBlockHeader> const& _uncles);
+
 }  // namespace toolimpl
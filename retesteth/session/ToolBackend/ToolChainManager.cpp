@@ -1,23 +1,27 @@
 #include "ToolChainManager.h"
 #include "ToolChainHelper.h"
 #include "ToolImplHelper.h"
+#include "TransactionValidation.h"
 #include <retesteth/EthChecks.h>
+#include <retesteth/Options.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/testStructures/Common.h>
 #include <retesteth/dataObject/ConvertFile.h>
 #include <retesteth/FileSystem.h>
+#include <thread>
 using namespace test;
 
 namespace toolimpl
 {
-ToolChainManager::ToolChainManager(spSetChainParamsArgs const& _config, fs::path const& _toolPath, fs::path const& _tmpDir)
+ToolChainManager::ToolChainManager(
+    spSetChainParamsArgs const& _config, fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer)
 {
     m_tmpDir = _tmpDir;
     m_toolPath = _toolPath;
     m_currentChain = 0;
     m_maxChains = 0;
     EthereumBlockState genesis(_config->genesis(), _config->state(), FH32::zero());
-    m_chains[m_currentChain] = spToolChain(new ToolChain(genesis, _config, _toolPath, _tmpDir));
+    m_chains[m_currentChain] = spToolChain(new ToolChain(genesis, _config, _toolPath, _tmpDir, _toolServer));
     m_pendingBlock =
         spEthereumBlockState(new EthereumBlockState(currentChain().lastBlock().header(), _config->state(), FH32::zero()));
     reorganizePendingBlock();
@@ -32,6 +36,34 @@ spDataObject const ToolChainManager::mineBlocks(size_t _number, ToolChain::Minin
     return res;
 }
 
+// State test transactions share the genesis and env, the tool input files are written once for all of them
+std::vector<MineTransactionResult> ToolChainManager::mineTransactionsBatch(
+    std::vector<spTransaction> const& _txs, VALUE const& _timestamp)
+{
+    if (currentChain().blocks().size() != 1)
+        throw test::UpwardsException("ToolChainManager::mineTransactionsBatch requires the chain to be at genesis!");
+
+    modifyTimestamp(_timestamp);
+    std::vector<EthereumBlockState> pendingBlocks;
+    for (auto const& tr : _txs)
+    {
+        EthereumBlockState pending(m_pendingBlock->header(), m_pendingBlock->state(), m_pendingBlock->logHash());
+        pending.addTransaction(tr);
+        pendingBlocks.push_back(pending);
+    }
+
+    std::vector<MineTransactionResult> results;
+    std::vector<ToolResponse> const responses = currentChainUnsafe().mineBlocksOnTool(pendingBlocks);
+    for (size_t i = 0; i < pendingBlocks.size(); i++)
+    {
+        spDataObject const res = currentChainUnsafe().mineBlock(pendingBlocks.at(i), responses.at(i));
+        spDataObject block = constructEthGetBlockBy(lastBlock());
+        results.emplace_back(MineBlocksResult(res), EthGetBlockBy(block), lastBlock().logHash());
+        rewindToBlock(0);
+    }
+    return results;
+}
+
 void ToolChainManager::rewindToBlock(VALUE const& _number)
 {
     size_t number = (size_t)_number.asBigInt();
@@ -190,7 +222,8 @@ void ToolChainManager::reorganizeChainForParent(FH32 const& _parentHash)
                 {
                     // clone existing chain up to this block
                     m_chains[++m_maxChains] =
-                        spToolChain(new ToolChain(blocks.at(0), rchain.params(), rchain.toolPath(), rchain.tmpDir()));
+                        spToolChain(new ToolChain(
+                            blocks.at(0), rchain.params(), rchain.toolPath(), rchain.tmpDir(), rchain.toolServer()));
                     m_currentChain = m_maxChains;
                     for (size_t j = 1; j <= i; j++)
                         m_chains[m_currentChain].getContent().insertBlock(blocks.at(j));
@@ -220,10 +253,35 @@ void ToolChainManager::reorganizeChainForTotalDifficulty()
 
 TestRawTransaction ToolChainManager::test_rawTransaction(
     BYTES const& _rlp, FORK const& _fork, fs::path const& _toolPath, fs::path const& _tmpDir)
+{
+    spDataObject const res = validateTransaction(_rlp, _fork);
+    if (res.isEmpty())
+        return TestRawTransaction(rawTransactionOnTool(_rlp, _fork, _toolPath, _tmpDir));
+
+    ETH_TEST_MESSAGE("Response: test_rawTransaction `" + res->asJson());
+    TestRawTransaction nativeRes(res);
+    if (Options::get().checkt9n)
+    {
+        // Use t9n as an oracle for the native transaction validation
+        TestRawTransaction const toolRes(rawTransactionOnTool(_rlp, _fork, _toolPath, _tmpDir));
+        string const prefix = "t9n vs retesteth transaction validation disagree (" + _fork.asString() + ", " + _rlp.asString() + "): ";
+        if (toolRes.error().empty() != nativeRes.error().empty())
+            ETH_ERROR_MESSAGE(prefix + "error `" + toolRes.error() + "` vs `" + nativeRes.error() + "`");
+        if (toolRes.sender() != nativeRes.sender())
+            ETH_ERROR_MESSAGE(prefix + "sender " + toolRes.sender().asString() + " vs " + nativeRes.sender().asString());
+        if (toolRes.intrinsicGas() != nativeRes.intrinsicGas())
+            ETH_ERROR_MESSAGE(prefix + "intrinsicGas " + toolRes.intrinsicGas().asDecString() + " vs " +
+                              nativeRes.intrinsicGas().asDecString());
+    }
+    return nativeRes;
+}
+
+spDataObject ToolChainManager::rawTransactionOnTool(
+    BYTES const& _rlp, FORK const& _fork, fs::path const& _toolPath, fs::path const& _tmpDir)
 {
     // Prepare test_mineBlocks response structure
-    DataObject out;
-    out["result"] = true;
+    spDataObject out;
+    (*out)["result"] = true;
 
     // Prepare transaction file
     fs::path txsPath = _tmpDir / "tx.rlp";
@@ -291,24 +349,73 @@ TestRawTransaction ToolChainManager::test_rawTransaction(
         (*tr)["error"] = resTr->atKey("error").asString();
         (*tr)["sender"] = FH20::zero().asString();
         (*tr)["hash"] = hash;
-        out["rejectedTransactions"].addArrayObject(tr);
+        (*out)["rejectedTransactions"].addArrayObject(tr);
     }
     else
     {
         (*tr)["sender"] = resTr->atKey("address").asString();
         (*tr)["hash"] = resTr->atKey("hash").asString();
-        out["acceptedTransactions"].addArrayObject(tr);
+        (*out)["acceptedTransactions"].addArrayObject(tr);
         if (tr->atKey("hash").asString() != hash)
             ETH_ERROR_MESSAGE("t8n tool returned different tx.hash than retesteth: (t8n.hash != retesteth.hash) " + tr->atKey("hash").asString() + " != " + hash);
     }
 
-    ETH_TEST_MESSAGE("Response: test_rawTransaction `" + out.asJson());
-    return TestRawTransaction(out);
+    ETH_TEST_MESSAGE("Response: test_rawTransaction `" + out->asJson());
+    return out;
 }
 
+namespace
+{
+DifficultyArgs makeDifficultyArgs(CalculateDifficultyArgs const& _args)
+{
+    if (_args.blockNumber() == 0)
+        ETH_ERROR_MESSAGE("ToolChainManager::test_calculateDifficulty calculating difficulty for blocknumber 0!");
+    DifficultyArgs args;
+    args.number = _args.blockNumber().asBigInt();
+    args.timestamp = _args.currentTimestamp().asBigInt();
+    args.parentTimestamp = _args.parentTimestamp().asBigInt();
+    args.parentDifficulty = _args.parentDifficulty().asBigInt();
+    args.parentHasUncles = _args.uncleNumber() > 0;
+    return args;
+}
+}  // namespace
+
+// When filling, forks with known difficulty rules are calculated by retesteth. Running the tests
+// and forks unknown to retesteth ask the tool, so the tests check the client
 VALUE ToolChainManager::test_calculateDifficulty(FORK const& _fork, VALUE const& _blockNumber, VALUE const& _parentTimestamp,
     VALUE const& _parentDifficulty, VALUE const& _currentTimestamp, VALUE const& _uncleNumber,
-    fs::path const& _toolPath, fs::path const& _tmpDir)
+    fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer)
+{
+    CalculateDifficultyArgs const arg(_blockNumber, _parentTimestamp, _parentDifficulty, _currentTimestamp, _uncleNumber);
+    return test_calculateDifficulty(_fork, {arg}, _toolPath, _tmpDir, _toolServer).at(0);
+}
+
+std::vector<VALUE> ToolChainManager::test_calculateDifficulty(FORK const& _fork,
+    std::vector<CalculateDifficultyArgs> const& _args, fs::path const& _toolPath, fs::path const& _tmpDir,
+    spToolServer const& _toolServer)
+{
+    DataObject forkParams;
+    forkParams["fork"] = _fork.asString();
+    ToolParams const toolParams(forkParams);
+    if (toolParams.knownFork() && Options::get().filltests)
+    {
+        std::vector<DifficultyArgs> args;
+        args.reserve(_args.size());
+        for (auto const& arg : _args)
+            args.push_back(makeDifficultyArgs(arg));
+
+        size_t const threads = std::max<size_t>(1, std::thread::hardware_concurrency() / Options::get().threadCount);
+        return calculateEthashDifficultyGrid(ChainOperationParams::defaultParams(toolParams), args, threads);
+    }
+
+    std::vector<VALUE> results;
+    for (auto const& arg : _args)
+        results.push_back(calculateDifficultyOnTool(_fork, arg, _toolPath, _tmpDir, _toolServer));
+    return results;
+}
+
+VALUE ToolChainManager::calculateDifficultyOnTool(FORK const& _fork, CalculateDifficultyArgs const& _args,
+    fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer)
 {
     DifficultyStatic const& data = prepareEthereumBlockStateTemplate();
 
@@ -317,24 +424,24 @@ VALUE ToolChainManager::test_calculateDifficulty(FORK const& _fork, VALUE const&
     EthereumBlockState blockB(data.blockA, data.state, data.loghash);
 
     BlockHeader& headerA = blockA.headerUnsafe().getContent();
-    headerA.setDifficulty(_parentDifficulty);
-    if (_blockNumber == 0)
+    headerA.setDifficulty(_args.parentDifficulty());
+    if (_args.blockNumber() == 0)
         ETH_ERROR_MESSAGE("ToolChainManager::test_calculateDifficulty calculating difficulty for blocknumber 0!");
-    headerA.setNumber(_blockNumber - 1);
-    headerA.setTimestamp(_parentTimestamp);
+    headerA.setNumber(_args.blockNumber() - 1);
+    headerA.setTimestamp(_args.parentTimestamp());
 
     // Set uncle hash to non empty
-    if (_uncleNumber > 0)
+    if (_args.uncleNumber() > 0)
         headerA.setUnclesHash(FH32("0x2dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347"));
     else
         headerA.setUnclesHash(FH32("0x1dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347"));
 
     BlockHeader& headerB = blockB.headerUnsafe().getContent();
-    headerB.setTimestamp(_currentTimestamp);
-    headerB.setNumber(_blockNumber);
+    headerB.setTimestamp(_args.currentTimestamp());
+    headerB.setNumber(_args.blockNumber());
     headerB.setParentHash(headerA.hash());
 
-    ToolChain chain(blockA, blockB, _fork, _toolPath, _tmpDir);
+    ToolChain chain(blockA, blockB, _fork, _toolPath, _tmpDir, _toolServer);
     return chain.lastBlock().header()->difficulty();
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 #include "ToolChain.h"
 #include <retesteth/testStructures/types/Ethereum/EthereumBlock.h>
+#include <retesteth/testStructures/types/RPC/CalculateDifficultyArgs.h>
 #include <retesteth/testStructures/types/RPC/EthGetBlockBy.h>
+#include <retesteth/testStructures/types/RPC/MineTransactionResult.h>
 #include <retesteth/testStructures/types/RPC/SetChainParamsArgs.h>
 #include <retesteth/testStructures/types/RPC/TestRawTranasction.h>
 #include <boost/filesystem.hpp>
@@ -15,7 +17,8 @@ namespace toolimpl
 class ToolChainManager : public GCP_SPointerBase
 {
 public:
-    ToolChainManager(spSetChainParamsArgs const& _config, fs::path const& _toolPath, fs::path const& _tmpDir);
+    ToolChainManager(spSetChainParamsArgs const& _config, fs::path const& _toolPath, fs::path const& _tmpDir,
+        spToolServer const& _toolServer);
     void addPendingTransaction(spTransaction const& _tr) { m_pendingBlock.getContent().addTransaction(_tr); }
 
     ToolChain const& currentChain() const
@@ -24,6 +27,7 @@ public:
         return m_chains.at(m_currentChain);
     }
     spDataObject const mineBlocks(size_t _number, ToolChain::Mining _req = ToolChain::Mining::AllowFailTransactions);
+    std::vector<MineTransactionResult> mineTransactionsBatch(std::vector<spTransaction> const& _txs, VALUE const& _timestamp);
     FH32 importRawBlock(BYTES const& _rlp);
 
     EthereumBlockState const& lastBlock() const { return currentChain().lastBlock(); }
@@ -39,11 +43,17 @@ public:
     // Difficulty tests
     static VALUE test_calculateDifficulty(FORK const& _fork, VALUE const& _blockNumber, VALUE const& _parentTimestamp,
         VALUE const& _parentDifficulty, VALUE const& _currentTimestamp, VALUE const& _uncleNumber,
-        fs::path const& _toolPath, fs::path const& _tmpDir);
+        fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer);
+    static std::vector<VALUE> test_calculateDifficulty(FORK const& _fork, std::vector<CalculateDifficultyArgs> const& _args,
+        fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer);
 
 
 private:
     ToolChainManager() {}
+    static spDataObject rawTransactionOnTool(
+        BYTES const& _rlp, FORK const& _fork, fs::path const& _toolPath, fs::path const& _tmpDir);
+    static VALUE calculateDifficultyOnTool(FORK const& _fork, CalculateDifficultyArgs const& _args,
+        fs::path const& _toolPath, fs::path const& _tmpDir, spToolServer const& _toolServer);
     ToolChain& currentChainUnsafe()
     {
         assert(m_chains.count(m_currentChain));
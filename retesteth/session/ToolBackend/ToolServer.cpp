@@ -0,0 +1,287 @@
+#include "ToolServer.h"
+#include <retesteth/EthChecks.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/dataObject/ConvertFile.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace test;
+
+namespace
+{
+size_t const c_maxFrameHeader = 20;
+// Time for the tool to exit after EOF on stdin, and after SIGTERM
+std::chrono::milliseconds const c_exitTimeout(2000);
+std::chrono::milliseconds const c_exitPollInterval(10);
+
+// Pipes of the server must not be inherited by the other tool processes
+bool createPipe(int _fds[2])
+{
+    if (pipe(_fds) == -1)
+        return false;
+    fcntl(_fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(_fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+}
+
+// Tool might die in the middle of the request. SIGPIPE is blocked on this thread while writing
+// to get EPIPE instead, the signal raised by the write is consumed before it is unblocked
+class SigpipeBlock
+{
+public:
+    SigpipeBlock()
+    {
+        sigemptyset(&m_pipeSet);
+        sigaddset(&m_pipeSet, SIGPIPE);
+        sigset_t pending;
+        sigpending(&pending);
+        m_wasPending = sigismember(&pending, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &m_pipeSet, &m_oldSet);
+    }
+    ~SigpipeBlock()
+    {
+        sigset_t pending;
+        sigpending(&pending);
+        if (!m_wasPending && sigismember(&pending, SIGPIPE))
+        {
+            int sig = 0;
+            sigwait(&m_pipeSet, &sig);
+        }
+        pthread_sigmask(SIG_SETMASK, &m_oldSet, nullptr);
+    }
+
+private:
+    sigset_t m_pipeSet;
+    sigset_t m_oldSet;
+    bool m_wasPending = false;
+};
+
+// Wait for the process to exit. Returns false on timeout
+bool waitExit(int _pid, std::chrono::milliseconds _timeout)
+{
+    auto const deadline = std::chrono::steady_clock::now() + _timeout;
+    int status = 0;
+    while (waitpid(_pid, &status, WNOHANG) == 0)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(c_exitPollInterval);
+    }
+    return true;
+}
+
+// Strings of DataObject are printed as stored, so the value is escaped here
+string escapeJsonString(string const& _str)
+{
+    string out;
+    out.reserve(_str.size());
+    for (char const ch : _str)
+    {
+        if (ch == '"' || ch == '\\')
+        {
+            out += '\\';
+            out += ch;
+        }
+        else if (ch == '\n')
+            out += "\\n";
+        else if (ch == '\t')
+            out += "\\t";
+        else if (uint8_t(ch) < 0x20)
+        {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", unsigned(uint8_t(ch)));
+            out += buffer;
+        }
+        else
+            out += ch;
+    }
+    return out;
+}
+}  // namespace
+
+namespace toolimpl
+{
+ToolServer::ToolServer(fs::path const& _toolPath, fs::path const& _tmpDir) : m_toolPath(_toolPath), m_tmpDir(_tmpDir)
+{
+    start();
+}
+
+ToolServer::~ToolServer()
+{
+    stop();
+}
+
+void ToolServer::start()
+{
+    int toTool[2];
+    int fromTool[2];
+    if (!createPipe(toTool))
+        throw UpwardsException("ToolServer: failed to create pipe!");
+    if (!createPipe(fromTool))
+    {
+        close(toTool[0]);
+        close(toTool[1]);
+        throw UpwardsException("ToolServer: failed to create pipe!");
+    }
+
+    string const cmd = m_toolPath.string() + " --server";
+    pid_t pid = fork();
+    if (pid == -1)
+    {
+        for (int fd : {toTool[0], toTool[1], fromTool[0], fromTool[1]})
+            close(fd);
+        throw UpwardsException("ToolServer: failed to fork `" + cmd + "`");
+    }
+
+    if (pid == 0)
+    {
+        // child process, the descriptors duplicated to stdin/stdout do not have FD_CLOEXEC
+        dup2(toTool[0], 0);
+        dup2(fromTool[1], 1);
+        if (!Options::get().enableClientsOutput)
+        {
+            int fdnull = open("/dev/null", O_WRONLY);
+            dup2(fdnull, 2);
+        }
+        close(toTool[0]);
+        close(toTool[1]);
+        close(fromTool[0]);
+        close(fromTool[1]);
+        if (chdir(m_tmpDir.c_str()) != 0)
+            _exit(1);
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*)NULL);
+        _exit(1);
+    }
+
+    close(toTool[0]);
+    close(fromTool[1]);
+    m_writeFd = toTool[1];
+    m_readFd = fromTool[0];
+    m_pid = pid;
+    ETH_LOG("ToolServer started: `" + cmd + "` pid: " + fto_string(m_pid), 6);
+}
+
+void ToolServer::stop()
+{
+    if (m_writeFd != -1)
+        close(m_writeFd);  // tool receives EOF on stdin and is expected to exit
+    if (m_readFd != -1)
+        close(m_readFd);
+    m_writeFd = -1;
+    m_readFd = -1;
+    if (m_pid > 0)
+    {
+        if (!waitExit(m_pid, c_exitTimeout))
+        {
+            ETH_WARNING("ToolServer pid " + fto_string(m_pid) + " did not exit on EOF, sending SIGTERM");
+            kill(m_pid, SIGTERM);
+            if (!waitExit(m_pid, c_exitTimeout))
+            {
+                kill(m_pid, SIGKILL);
+                int status = 0;
+                waitpid(m_pid, &status, 0);
+            }
+        }
+        ETH_LOG("ToolServer stopped pid: " + fto_string(m_pid), 6);
+    }
+    m_pid = 0;
+}
+
+spDataObject ToolServer::requestT8n(
+    string const& _args, DataObject const& _alloc, DataObject const& _env, string const& _txs)
+{
+    spDataObject req;
+    (*req)["method"] = "t8n";
+    (*req)["args"] = escapeJsonString(_args);
+    (*req).atKeyPointer("alloc") = _alloc.copy();
+    (*req).atKeyPointer("env") = _env.copy();
+    spDataObject const txs = dataobject::ConvertJsoncppStringToData("{\"txs\":" + _txs + "}");
+    (*req).atKeyPointer("txs") = txs->atKey("txs").copy();
+    return request(req->asJson(0, false));
+}
+
+spDataObject ToolServer::request(string const& _payload)
+{
+    if (!isRunning())
+        throw UpwardsException("ToolServer: request to a stopped tool server!");
+    try
+    {
+        writeFrame(_payload);
+        string const response = readFrame();
+        spDataObject res = dataobject::ConvertJsoncppStringToData(response);
+        if (res->count("error"))
+            throw UpwardsException("ToolServer: tool returned error: " + res->atKey("error").asString());
+        return res;
+    }
+    catch (std::exception const& _ex)
+    {
+        // Do not reuse the session with broken protocol state
+        stop();
+        throw UpwardsException(string("ToolServer: ") + _ex.what());
+    }
+}
+
+void ToolServer::writeFrame(string const& _payload)
+{
+    string const header = fto_string(_payload.size()) + "\n";
+    SigpipeBlock const sigpipeBlock;
+    for (string const* part : {&header, &_payload})
+    {
+        size_t written = 0;
+        while (written < part->size())
+        {
+            ssize_t const res = write(m_writeFd, part->data() + written, part->size() - written);
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res <= 0)
+                throw UpwardsException("write to tool failed (tool exited?)");
+            written += res;
+        }
+    }
+}
+
+void ToolServer::readBytes(char* _buffer, size_t _size)
+{
+    size_t received = 0;
+    while (received < _size)
+    {
+        ssize_t const res = read(m_readFd, _buffer + received, _size - received);
+        if (res < 0 && errno == EINTR)
+            continue;
+        if (res <= 0)
+            throw UpwardsException("read from tool failed (tool exited?)");
+        received += res;
+    }
+}
+
+string ToolServer::readFrame()
+{
+    string header;
+    char ch = 0;
+    while (true)
+    {
+        readBytes(&ch, 1);
+        if (ch == '\n')
+            break;
+        if (!isdigit(ch) || header.size() > c_maxFrameHeader)
+            throw UpwardsException("malformed response frame header: `" + header + ch + "`");
+        header += ch;
+    }
+    if (header.empty())
+        throw UpwardsException("empty response frame header");
+
+    string payload(std::stoull(header), '\0');
+    if (payload.size())
+        readBytes(&payload[0], payload.size());
+    return payload;
+}
+
+}  // namespace toolimpl
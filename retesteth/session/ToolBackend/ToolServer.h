@@ -0,0 +1,47 @@
+#pragma once
+#include <retesteth/dataObject/DataObject.h>
+#include <boost/filesystem.hpp>
+#include <string>
+namespace fs = boost::filesystem;
+using namespace dataobject;
+
+namespace toolimpl
+{
+// Long living transition tool process (`tool --server`)
+// Requests and responses are streamed over the tool stdin/stdout
+// Each message is framed as `<payload size in bytes>\n<json payload>`
+class ToolServer : public GCP_SPointerBase
+{
+public:
+    ToolServer(fs::path const& _toolPath, fs::path const& _tmpDir);
+    ~ToolServer();
+
+    // Server process is alive and did not break the protocol
+    bool isRunning() const { return m_pid > 0; }
+
+    // Send the request and wait for the response
+    // Throws UpwardsException and stops the server if the session is broken
+    spDataObject request(std::string const& _payload);
+
+    // Request of t8n with the input passed in the request instead of the files
+    // _args are the command line arguments of the tool, _txs is json array of the transactions
+    spDataObject requestT8n(
+        std::string const& _args, DataObject const& _alloc, DataObject const& _env, std::string const& _txs);
+    void stop();
+
+private:
+    ToolServer() {}
+    void start();
+    void writeFrame(std::string const& _payload);
+    std::string readFrame();
+    void readBytes(char* _buffer, size_t _size);
+
+    fs::path m_toolPath;
+    fs::path m_tmpDir;
+    int m_pid = 0;
+    int m_writeFd = -1;
+    int m_readFd = -1;
+};
+
+typedef GCP_SPointer<ToolServer> spToolServer;
+}  // namespace toolimpl
@@ -0,0 +1,209 @@
+#include "TransactionValidation.h"
+#include "ToolChainHelper.h"
+#include <libdevcore/SHA3.h>
+#include <libdevcrypto/Common.h>
+#include <retesteth/EthChecks.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/testStructures/types/Ethereum/TransactionAccessList.h>
+#include <retesteth/testStructures/types/Ethereum/TransactionBaseFee.h>
+#include <retesteth/testStructures/types/Ethereum/TransactionReader.h>
+
+using namespace std;
+using namespace dev;
+using namespace test;
+using namespace toolimpl;
+
+namespace
+{
+bigint const c_maxUint64 = (bigint(1) << 64) - 1;
+u256 const c_secp256k1n("115792089237316195423570985008687907852837564279074904382605163141518161494337");
+
+// Errors are reported with the same messages as geth t9n
+string const c_errTypeNotSupported = "transaction type not supported";
+string const c_errInvalidSig = "invalid transaction v, r, s values";
+string const c_errInvalidChainId = "invalid chain id for signer";
+string const c_errIntrinsicGas = "intrinsic gas too low";
+string const c_errNonceMax = "nonce has max value";
+string const c_errTipAboveFeeCap = "max priority fee per gas higher than max fee per gas";
+
+struct SenderRecovery
+{
+    Address sender;
+    string error;
+};
+
+// Transaction must encode back into the same rlp, other encodings are the decoding errors of the tool
+// Typed transactions are encoded with chain id 1, so the chain id of typed transaction is checked here too
+bool isCanonical(Transaction const& _tr, bytes const& _raw)
+{
+    if (sfromHex(_tr.getRawBytes().asString()) != _raw)
+        return false;
+
+    std::vector<VALUE const*> values = {&_tr.nonce(), &_tr.gasLimit(), &_tr.value(), &_tr.v(), &_tr.r(), &_tr.s()};
+    if (_tr.type() == TransactionType::BASEFEE)
+    {
+        TransactionBaseFee const& tr = static_cast<TransactionBaseFee const&>(_tr);
+        values.push_back(&tr.maxFeePerGas());
+        values.push_back(&tr.maxPriorityFeePerGas());
+    }
+    else
+        values.push_back(&static_cast<TransactionLegacy const&>(_tr).gasPrice());
+
+    for (auto const* value : values)
+        if (value->isBigInt())
+            return false;
+    return _tr.nonce().asBigInt() <= c_maxUint64 && _tr.gasLimit().asBigInt() <= c_maxUint64;
+}
+
+// Sender recovery with the signer rules of the fork (geth types.MakeSigner)
+SenderRecovery recoverSender(Transaction const& _tr, ForkOrder _fork)
+{
+    SenderRecovery res;
+    TransactionType const type = _tr.type();
+    if ((type == TransactionType::ACCESSLIST && _fork < ForkOrder::Berlin) ||
+        (type == TransactionType::BASEFEE && _fork < ForkOrder::London))
+    {
+        res.error = c_errTypeNotSupported;
+        return res;
+    }
+
+    bigint const v = _tr.v().asBigInt();
+    bigint recoveryId;
+    bool homestead = true;
+    if (type == TransactionType::LEGACY)
+    {
+        bool const chainIdSigned = v != 0 && v != 1 && v != 27 && v != 28;
+        if (_fork >= ForkOrder::EIP158 && chainIdSigned)
+        {
+            // EIP-155: v = chainId * 2 + 35 + {0, 1}
+            if (v != 37 && v != 38)
+            {
+                bigint const diff = v - 35;
+                bigint const chainId = diff >= 0 ? bigint(diff / 2) : bigint(-((-diff + 1) / 2));
+                res.error = c_errInvalidChainId + ": have " + chainId.str() + " want 1";
+                return res;
+            }
+            recoveryId = v - 37;
+        }
+        else
+        {
+            recoveryId = v - 27;
+            homestead = _fork >= ForkOrder::Homestead;
+        }
+    }
+    else
+        recoveryId = v;
+
+    u256 const r = u256(_tr.r().asBigInt());
+    u256 const s = u256(_tr.s().asBigInt());
+    if (recoveryId < 0 || recoveryId > 1 || r < 1 || s < 1 || r >= c_secp256k1n || s >= c_secp256k1n ||
+        (homestead && s > c_secp256k1n / 2))
+    {
+        res.error = c_errInvalidSig;
+        return res;
+    }
+
+    SignatureStruct const sig(h256(r), h256(s), (dev::byte)recoveryId);
+    Public const pub = dev::recover(sig, _tr.signingHash());
+    if (!pub)
+    {
+        res.error = c_errInvalidSig;
+        return res;
+    }
+    res.sender = toAddress(pub);
+    return res;
+}
+
+bigint calculateIntrinsicGas(Transaction const& _tr, ForkOrder _fork)
+{
+    bigint gas = (_tr.isCreation() && _fork >= ForkOrder::Homestead) ? 53000 : 21000;
+
+    // EIP-2028 Istanbul calldata gas cost reduction
+    size_t const nonZeroGas = _fork >= ForkOrder::Istanbul ? 16 : 68;
+    for (auto const& b : sfromHex(_tr.data().asString()))
+        gas += b ? nonZeroGas : 4;
+
+    // EIP-2930 access list gas
+    AccessList const* accessList = nullptr;
+    if (_tr.type() == TransactionType::ACCESSLIST)
+        accessList = &static_cast<TransactionAccessList const&>(_tr).accessList();
+    else if (_tr.type() == TransactionType::BASEFEE)
+        accessList = &static_cast<TransactionBaseFee const&>(_tr).accessList();
+    if (accessList)
+        for (auto const& el : accessList->list())
+            gas += 2400 + 1900 * el->keys().size();
+    return gas;
+}
+
+spDataObject makeResponse(string const& _hash, Address const& _sender, bigint const& _intrinsicGas, string const& _error)
+{
+    spDataObject out;
+    (*out)["result"] = true;
+
+    spDataObject tr;
+    (*tr)["intrinsicGas"] = VALUE(_intrinsicGas).asString();
+    (*tr)["hash"] = _hash;
+    if (_error.empty())
+    {
+        (*tr)["sender"] = "0x" + toString(_sender);
+        (*out)["acceptedTransactions"].addArrayObject(tr);
+    }
+    else
+    {
+        (*tr)["error"] = _error;
+        (*tr)["sender"] = FH20::zero().asString();
+        (*out)["rejectedTransactions"].addArrayObject(tr);
+    }
+    return out;
+}
+}  // namespace
+
+namespace toolimpl
+{
+spDataObject validateTransaction(BYTES const& _rlp, FORK const& _fork)
+{
+    ForkOrder const fork = forkOrder(_fork);
+    if (fork == ForkOrder::Unknown)
+        return spDataObject(0);
+
+    bytes const raw = sfromHex(_rlp.asString());
+    spTransaction tr;
+    try
+    {
+        tr = readTransaction(_rlp);
+        if (!isCanonical(tr, raw))
+            return spDataObject(0);
+    }
+    catch (std::exception const& _ex)
+    {
+        ETH_LOG(string("validateTransaction could not decode transaction: ") + _ex.what(), 6);
+        return spDataObject(0);
+    }
+
+    string const hash = "0x" + toString(sha3(raw));
+    SenderRecovery const recovery = recoverSender(tr, fork);
+    if (!recovery.error.empty())
+        return makeResponse(hash, Address(), 0, recovery.error);
+
+    bigint const intrinsicGas = calculateIntrinsicGas(tr, fork);
+    if (tr->gasLimit().asBigInt() < intrinsicGas)
+    {
+        string const error = c_errIntrinsicGas + ": have " + tr->gasLimit().asDecString() + ", want " + intrinsicGas.str();
+        return makeResponse(hash, Address(), intrinsicGas, error);
+    }
+
+    // EIP-2681 nonce limit
+    if (tr->nonce().asBigInt() == c_maxUint64)
+        return makeResponse(hash, Address(), intrinsicGas, c_errNonceMax);
+
+    if (tr->type() == TransactionType::BASEFEE)
+    {
+        TransactionBaseFee const& feeTr = static_cast<TransactionBaseFee const&>(tr.getCContent());
+        if (feeTr.maxPriorityFeePerGas() > feeTr.maxFeePerGas())
+            return makeResponse(hash, Address(), intrinsicGas, c_errTipAboveFeeCap);
+    }
+
+    return makeResponse(hash, recovery.sender, intrinsicGas, string());
+}
+
+}  // namespace toolimpl
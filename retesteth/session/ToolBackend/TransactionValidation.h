@@ -0,0 +1,17 @@
+#pragma once
+#include <retesteth/dataObject/DataObject.h>
+#include <retesteth/testStructures/basetypes.h>
+#include <retesteth/testStructures/configs/FORK.h>
+
+using namespace dataobject;
+using namespace test::teststruct;
+
+namespace toolimpl
+{
+// Validate the transaction rlp with the rules of t9n tool without starting the tool
+// Sender is recovered with secp256k1, intrinsic gas is calculated with the fork rules
+// Returns test_rawTransaction response or empty pointer if the fork is unknown
+// or the rlp could not be decoded (the exact decoding error is expected from the tool)
+spDataObject validateTransaction(BYTES const& _rlp, FORK const& _fork);
+
+}  // namespace toolimpl
@@ -219,4 +219,18 @@ void verifyEthereumBlockHeader(spBlockHeader const& _header, ToolChain const& _c
             "verifyEthereumBlockHeader:: Parent block hash not found: " + _header->parentHash().asString());
 }
 
+void verifyEthereumBlockRoots(EthereumBlockState const& _block)
+{
+    BlockHeader const& header = _block.header();
+    FH32 const txRoot = calculateTransactionRoot(_block.transactions());
+    if (header.transactionRoot() != txRoot)
+        ETH_ERROR_MESSAGE("tool vs retesteth transactionRoot disagree: " + header.transactionRoot().asString() +
+                          " vs " + txRoot.asString());
+
+    FH32 const stateRoot = calculateStateRoot(_block.state());
+    if (header.stateRoot() != stateRoot)
+        ETH_ERROR_MESSAGE("tool vs retesteth stateRoot disagree: " + header.stateRoot().asString() + " vs " +
+                          stateRoot.asString());
+}
+
 }  // namespace toolimpl
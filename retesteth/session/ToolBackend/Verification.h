@@ -11,4 +11,7 @@ const size_t INITIAL_BASE_FEE = 1000000000;
 // Blockchain logic validator
 void verifyEthereumBlockHeader(spBlockHeader const& _header, ToolChain const& _chain);
 
+// Check tool transactionRoot and stateRoot against the trie roots calculated by retesteth
+void verifyEthereumBlockRoots(EthereumBlockState const& _block);
+
 }  // namespace toolimpl
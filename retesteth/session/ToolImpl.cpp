@@ -42,6 +42,18 @@ enum class CallType
         ETH_FAIL_MESSAGE(_ex.what());                                                                      \
     }                                                                                                      \
 
+ToolImpl::ToolImpl(Socket::SocketType _type, fs::path const& _path, fs::path const& _tmpDir, ClientConfgToolMode _mode)
+  : m_sockType(_type), m_toolPath(_path), m_tmpDir(_tmpDir)
+{
+    if (_mode == ClientConfgToolMode::Server)
+    {
+        TRYCATCHCALL(
+            m_toolServer = spToolServer(new ToolServer(m_toolPath, m_tmpDir));
+            , "ToolServer", CallType::DONTFAILONUPWARDS)
+        if (m_toolServer.isEmpty())
+            ETH_WARNING("Failed to start tool server, using file mode: " + m_lastInterfaceError.message());
+    }
+}
 
 spDataObject ToolImpl::web3_clientVersion()
 {
@@ -228,6 +240,30 @@ DebugVMTrace ToolImpl::debug_traceTransaction(FH32 const& _trHash)
     return DebugVMTrace();
 }
 
+std::vector<spAccountBase> ToolImpl::debug_getAccountsBatch(
+    VALUE const& _blockNumber, VALUE const& _txIndex, std::vector<FH20> const& _addresses, size_t _sizeLimit)
+{
+    rpcCall("", {});
+    ETH_TEST_MESSAGE("\nRequest: debug_getAccountsBatch bl:" + _blockNumber.asDecString() +
+                     " accounts:" + fto_string(_addresses.size()));
+    (void) _txIndex;
+    (void) _sizeLimit;  // the state is in memory, nothing to download
+
+    TRYCATCHCALL(
+        // Make a copy here because we do not expose the memory of the tool backend
+        std::vector<spAccountBase> accounts;
+        State const& state = blockchain().blockByNumber(_blockNumber).state();
+        for (auto const& address : _addresses)
+        {
+            spDataObject data = state.getAccount(address).asDataObject()->copy();
+            accounts.push_back(spAccountBase(new State::Account(data)));
+        }
+        ETH_TEST_MESSAGE("Response: debug_getAccountsBatch " + fto_string(accounts.size()) + " accounts");
+        return accounts;
+        , "debug_getAccountsBatch", CallType::FAILEVERYTHING)
+    return std::vector<spAccountBase>();
+}
+
 // Test
 void ToolImpl::test_setChainParams(spSetChainParamsArgs const& _config)
 {
@@ -236,7 +272,7 @@ void ToolImpl::test_setChainParams(spSetChainParamsArgs const& _config)
 
     // Ask tool to calculate genesis header stateRoot for genesisHeader
     TRYCATCHCALL(
-        m_toolChainManager = GCP_SPointer<ToolChainManager>(new ToolChainManager(_config, m_toolPath, m_tmpDir));
+        m_toolChainManager = GCP_SPointer<ToolChainManager>(new ToolChainManager(_config, m_toolPath, m_tmpDir, m_toolServer));
         ETH_TEST_MESSAGE("Response test_setChainParams: {true}");
         , "test_setChainParams", CallType::FAILEVERYTHING)
     ETH_TEST_MESSAGE("Response test_setChainParams: {false}");
@@ -322,11 +358,35 @@ VALUE ToolImpl::test_calculateDifficulty(FORK const& _fork, VALUE const& _blockN
         ETH_TEST_MESSAGE("Fork: " + _fork.asString() + ", bn: " + _blockNumber.asString() + ", pt: " + _parentTimestamp.asString() +
             ", pd: " + _parentDifficulty.asString() + ", ct: " + _currentTimestamp.asString() + ", un: " + _uncleNumber.asString());
         return ToolChainManager::test_calculateDifficulty(_fork, _blockNumber, _parentTimestamp, _parentDifficulty, _currentTimestamp, _uncleNumber,
-            m_toolPath, m_tmpDir);
+            m_toolPath, m_tmpDir, m_toolServer);
         , "test_calculateDifficulty", CallType::FAILEVERYTHING)
     return VALUE(DataObject());
 }
 
+std::vector<VALUE> ToolImpl::test_calculateDifficulty(FORK const& _fork, std::vector<CalculateDifficultyArgs> const& _args)
+{
+    rpcCall("", {});
+    TRYCATCHCALL(
+        ETH_TEST_MESSAGE("\nRequest: test_calculateDifficulty '");
+        ETH_TEST_MESSAGE("Fork: " + _fork.asString() + ", vectors: " + fto_string(_args.size()));
+        return ToolChainManager::test_calculateDifficulty(_fork, _args, m_toolPath, m_tmpDir, m_toolServer);
+        , "test_calculateDifficulty", CallType::FAILEVERYTHING)
+    return std::vector<VALUE>();
+}
+
+std::vector<MineTransactionResult> ToolImpl::test_mineTransactionsBatch(
+    std::vector<spTransaction> const& _txs, VALUE const& _timestamp)
+{
+    rpcCall("", {});
+    TRYCATCHCALL(
+        ETH_TEST_MESSAGE("\nRequest: test_mineTransactionsBatch " + fto_string(_txs.size()) + " transactions");
+        std::vector<MineTransactionResult> res = blockchain().mineTransactionsBatch(_txs, _timestamp);
+        ETH_TEST_MESSAGE("Response: test_mineTransactionsBatch " + fto_string(res.size()) + " results");
+        return res;
+        , "test_mineTransactionsBatch", CallType::FAILEVERYTHING)
+    return std::vector<MineTransactionResult>();
+}
+
 // Internal
 spDataObject ToolImpl::rpcCall(
     std::string const& _methodName, std::vector<std::string> const& _args, bool _canFail)
@@ -350,6 +410,11 @@ std::string const& ToolImpl::getSocketPath() const
     return m_toolPath.string();
 }
 
+double ToolImpl::getAverageLatency() const
+{
+    return 0;
+}
+
 void ToolImpl::makeRPCError(string const& _error)
 {
     ETH_LOG("makeRPCError " + _error, 5);
@@ -3,15 +3,14 @@
 #include <retesteth/TestHelper.h>
 #include <retesteth/session/SessionInterface.h>
 #include <retesteth/session/Socket.h>
+#include <retesteth/testStructures/configs/ClientConfigFile.h>
 #include <string>
 using namespace toolimpl;
 
 class ToolImpl : public SessionInterface
 {
 public:
-    ToolImpl(Socket::SocketType _type, fs::path const& _path, fs::path const& _tmpDir)
-      : m_sockType(_type), m_toolPath(_path), m_tmpDir(_tmpDir)
-    {}
+    ToolImpl(Socket::SocketType _type, fs::path const& _path, fs::path const& _tmpDir, ClientConfgToolMode _mode);
 
 public:
     spDataObject web3_clientVersion() override;
@@ -37,6 +36,8 @@ public:
     DebugStorageRangeAt debug_storageRangeAt(
         FH32 const& _blockHash, VALUE const& _txIndex, FH20 const& _address, FH32 const& _begin, int _maxResults) override;
     DebugVMTrace debug_traceTransaction(FH32 const& _trHash) override;
+    std::vector<spAccountBase> debug_getAccountsBatch(VALUE const& _blockNumber, VALUE const& _txIndex,
+        std::vector<FH20> const& _addresses, size_t _sizeLimit) override;
 
     // Test
     void test_setChainParams(spSetChainParamsArgs const& _config) override;
@@ -48,6 +49,9 @@ public:
     TestRawTransaction test_rawTransaction(BYTES const& _rlp, FORK const& _fork) override;
     VALUE test_calculateDifficulty(FORK const& _fork, VALUE const& _blockNumber, VALUE const& _parentTimestamp,
         VALUE const& _parentDifficulty, VALUE const& _currentTimestamp, VALUE const& _uncleNumber) override;
+    std::vector<VALUE> test_calculateDifficulty(FORK const& _fork, std::vector<CalculateDifficultyArgs> const& _args) override;
+    std::vector<MineTransactionResult> test_mineTransactionsBatch(
+        std::vector<spTransaction> const& _txs, VALUE const& _timestamp) override;
 
     // Internal
     std::string sendRawRequest(std::string const& _request);
@@ -56,6 +60,7 @@ public:
         bool _canFail = false) override;
     Socket::SocketType getSocketType() const override;
     std::string const& getSocketPath() const override;
+    double getAverageLatency() const override;
 
 private:
     Socket::SocketType m_sockType;
@@ -67,4 +72,7 @@ private:
 
     // Manage blockchains as ethereum client backend
     GCP_SPointer<ToolChainManager> m_toolChainManager;
+
+    // Long living tool process if the tool supports server mode
+    spToolServer m_toolServer;
 };
@@ -61,8 +61,10 @@ void mod_keyToLowerCase(DataObject& _obj)
 {
     if (!_obj.getKey().empty())
     {
-        string& value = _obj.getKeyUnsafe();
+        // setKey keeps the old key for the parent lookups only if the key changes
+        string value = _obj.getKey();
         std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return std::tolower(c); });
+        _obj.setKey(value);
     }
 }
 
@@ -168,14 +170,13 @@ void mod_valueInsertZeroXPrefix(DataObject& _obj)
 
 void mod_sortKeys(DataObject& _obj)
 {
-    std::map<string, spDataObject> const map = _obj.getSubObjectKeys();
-    if (map.size() > 1)
-    {
-        _obj.clearSubobjects();
-        _obj.setAutosort(true);
-        for (auto const& el : map)
-            _obj.atKeyPointer(el.second->getKey()) = el.second;
-    }
+    if (_obj.type() != DataType::Object || _obj.getSubObjects().size() <= 1)
+        return;
+    std::vector<spDataObject> const subObjects = _obj.getSubObjects();
+    _obj.clearSubobjects();
+    _obj.setAutosort(true);
+    for (auto const& el : subObjects)
+        _obj.atKeyPointer(el->getKey()) = el;
 }
 
 long long int hexOrDecStringToInt(string const& _str)
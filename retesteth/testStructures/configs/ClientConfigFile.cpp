@@ -29,6 +29,10 @@ void ClientConfigFile::initWithData(DataObject const& _data)
             {"socketAddress", {{DataType::String, DataType::Array}, jsonField::Required}},
             {"initializeTime", {{DataType::String}, jsonField::Optional}},
             {"checkLogsHash", {{DataType::Bool}, jsonField::Optional}},
+            {"maxRangePage", {{DataType::String}, jsonField::Optional}},
+            {"recycleMemory", {{DataType::String}, jsonField::Optional}},
+            {"recycleLatency", {{DataType::String}, jsonField::Optional}},
+            {"toolMode", {{DataType::String}, jsonField::Optional}},
             {"forks", {{DataType::Array}, jsonField::Required}},
             {"additionalForks", {{DataType::Array}, jsonField::Required}},
             {"exceptions", {{DataType::Object}, jsonField::Required}},
@@ -111,6 +115,51 @@ void ClientConfigFile::initWithData(DataObject const& _data)
     if (_data.count("checkLogsHash"))
         m_checkLogsHash = _data.atKey("checkLogsHash").asBool();
 
+    // Page size limit of debug_accountRange and debug_storageRangeAt
+    // `unlimited` if the client can return the whole range in one response
+    m_maxRangePage = 256;
+    if (_data.count("maxRangePage"))
+    {
+        string const& maxRangePageStr = _data.atKey("maxRangePage").asString();
+        if (maxRangePageStr == "unlimited")
+            m_maxRangePage = 0;
+        else
+        {
+            int const maxRangePage = atoi(maxRangePageStr.c_str());
+            if (maxRangePage <= 0)
+                ETH_FAIL_MESSAGE(sErrorPath + "`maxRangePage` must be a positive number or 'unlimited'!");
+            m_maxRangePage = maxRangePage;
+        }
+    }
+
+    // Client instances started by the ipc script are restarted when they pass these limits
+    // Without the limits all clients are restarted after a fixed number of test runs
+    auto readLimit = [this, &_data, &sErrorPath](string const& _field) -> size_t {
+        if (!_data.count(_field))
+            return 0;
+        int const limit = atoi(_data.atKey(_field).asString().c_str());
+        if (limit <= 0)
+            ETH_FAIL_MESSAGE(sErrorPath + "`" + _field + "` must be a positive number!");
+        if (m_socketType != ClientConfgSocketType::IPC)
+            ETH_FAIL_MESSAGE(sErrorPath + "`" + _field + "` is only allowed for socketType::ipc!");
+        return limit;
+    };
+    m_recycleMemory = readLimit("recycleMemory");
+    m_recycleLatency = readLimit("recycleLatency");
+
+    // Transition tool might support a long living server mode (`tool --server`)
+    m_toolMode = ClientConfgToolMode::Files;
+    if (_data.count("toolMode"))
+    {
+        string const& toolModeStr = _data.atKey("toolMode").asString();
+        if (m_socketType != ClientConfgSocketType::TransitionTool)
+            ETH_FAIL_MESSAGE(sErrorPath + "`toolMode` is only allowed for socketType::transition-tool!");
+        if (toolModeStr == "server")
+            m_toolMode = ClientConfgToolMode::Server;
+        else if (toolModeStr != "files")
+            ETH_FAIL_MESSAGE(sErrorPath + "Unknown `toolMode` : " + toolModeStr + ", Allowed: ['files', 'server']");
+    }
+
     // Read forks as fork order. Order is required for translation (`>=Frontier` -> `Frontier,
     // Homestead`) According to this order:
     for (auto const& el : _data.atKey("forks").getSubObjects())
@@ -20,6 +20,12 @@ enum class ClientConfgSocketType
     TransitionTool
 };
 
+enum class ClientConfgToolMode
+{
+    Files,  // Run the tool on each request with input/output files
+    Server  // Keep the tool running and stream the requests into it
+};
+
 struct ClientConfigFile : GCP_SPointerBase
 {
     ClientConfigFile(DataObject const& _data);
@@ -33,6 +39,10 @@ struct ClientConfigFile : GCP_SPointerBase
     std::vector<FORK> const& additionalForks() const { return m_additionalForks; }
     std::set<FORK> allowedForks() const;
     bool checkLogsHash() const { return m_checkLogsHash; }
+    size_t maxRangePage() const { return m_maxRangePage; }
+    size_t recycleMemory() const { return m_recycleMemory; }
+    size_t recycleLatency() const { return m_recycleLatency; }
+    ClientConfgToolMode toolMode() const { return m_toolMode; }
 
     std::map<string, string> const& exceptions() const { return m_exceptions; }
     std::map<string, string> const& fieldreplace() const { return m_fieldRaplce; }
@@ -49,6 +59,10 @@ private:
     ClientConfgSocketType m_socketType;      ///< Connection type
     std::vector<IPADDRESS> m_socketAddress;  ///< List of IP to connect to (IP::PORT)
     bool m_checkLogsHash;                    ///< Enable logsHash verification
+    size_t m_maxRangePage;                   ///< Max page of debug range requests (0 - client returns all)
+    size_t m_recycleMemory;                  ///< Restart the client instance above this memory (MB, 0 - not set)
+    size_t m_recycleLatency;                 ///< Restart the client instance above this eth_blockNumber latency (ms, 0 - not set)
+    ClientConfgToolMode m_toolMode;          ///< Transition tool communication mode
 
     size_t m_initializeTime;                 ///< Time to start the instance
     std::vector<FORK> m_forks;               ///< Allowed forks as network name
@@ -37,6 +37,9 @@ struct Transaction : GCP_SPointerBase
     VALUE const& s() const { return m_s; }
 
     FH32 const& hash() const { return m_hash; }
+
+    // Hash of the unsigned transaction that the sender signs
+    virtual dev::h256 signingHash() const = 0;
     BYTES const& getRawBytes() const { return m_rawRLPdata; }
     dev::RLPStream const& asRLPStream() const { return m_outRlpStream; }
 
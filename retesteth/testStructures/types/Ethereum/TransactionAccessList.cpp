@@ -160,6 +160,16 @@ void TransactionAccessList::buildVRS(VALUE const& _secret)
     rebuildRLP();
 }
 
+dev::h256 TransactionAccessList::signingHash() const
+{
+    dev::RLPStream stream;
+    stream.appendList(8);
+    TransactionAccessList::streamHeader(stream);
+    dev::bytes outa = stream.out();
+    outa.insert(outa.begin(), dev::byte(1));  // txType
+    return dev::sha3(outa);
+}
+
 void TransactionAccessList::streamHeader(dev::RLPStream& _s) const
 {
     // rlp([chainId, nonce, gasPrice, gasLimit, to, value, data, access_list, yParity, senderR, senderS])
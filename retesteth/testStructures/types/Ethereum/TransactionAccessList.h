@@ -16,6 +16,8 @@ struct TransactionAccessList : TransactionLegacy
 
     spDataObject const asDataObject(ExportOrder _order = ExportOrder::Default) const override;
     TransactionType type() const override { return TransactionType::ACCESSLIST; }
+    dev::h256 signingHash() const override;
+    AccessList const& accessList() const { return m_accessList; }
 
 protected:
     TransactionAccessList() {}
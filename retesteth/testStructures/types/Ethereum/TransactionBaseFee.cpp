@@ -166,6 +166,16 @@ void TransactionBaseFee::buildVRS(VALUE const& _secret)
     rebuildRLP();
 }
 
+dev::h256 TransactionBaseFee::signingHash() const
+{
+    dev::RLPStream stream;
+    stream.appendList(9);
+    streamHeader(stream);
+    dev::bytes outa = stream.out();
+    outa.insert(outa.begin(), dev::byte(2));  // txType
+    return dev::sha3(outa);
+}
+
 void TransactionBaseFee::streamHeader(dev::RLPStream& _s) const
 {
     // rlp([chainId, nonce, maxPriorityFeePerGas, maxFeePerGas, gasLimit, to, value, data, access_list, signatureYParity,
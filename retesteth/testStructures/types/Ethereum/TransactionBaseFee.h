@@ -15,6 +15,10 @@ struct TransactionBaseFee : Transaction
 
     spDataObject const asDataObject(ExportOrder _order = ExportOrder::Default) const override;
     TransactionType type() const override { return TransactionType::BASEFEE; }
+    dev::h256 signingHash() const override;
+    AccessList const& accessList() const { return m_accessList; }
+    VALUE const& maxFeePerGas() const { return m_maxFeePerGas; }
+    VALUE const& maxPriorityFeePerGas() const { return m_maxPriorityFeePerGas; }
 
 private:
     void fromRLP(dev::RLP const&) override;
@@ -163,6 +163,17 @@ void TransactionLegacy::buildVRS(VALUE const& _secret)
     rebuildRLP();
 }
 
+dev::h256 TransactionLegacy::signingHash() const
+{
+    // EIP-155 transactions sign the chain id: v = chainId * 2 + 35 + {0, 1}
+    bool const chainIdSigned = v() >= 35;
+    dev::RLPStream stream;
+    stream.appendList(chainIdSigned ? 9 : 6);
+    TransactionLegacy::streamHeader(stream);
+    if (chainIdSigned)
+        stream << bigint((v().asBigInt() - 35) / 2) << dev::u256(0) << dev::u256(0);
+    return dev::sha3(stream.out());
+}
 
 const spDataObject TransactionLegacy::asDataObject(ExportOrder _order) const
 {
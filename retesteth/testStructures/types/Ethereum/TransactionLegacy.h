@@ -21,6 +21,8 @@ struct TransactionLegacy : Transaction
     // Transaction legacy fields
     VALUE const& gasPrice() const { return m_gasPrice; }
 
+    virtual dev::h256 signingHash() const override;
+
     virtual TransactionType type() const override { return TransactionType::LEGACY; }
     virtual spDataObject const asDataObject(ExportOrder _order = ExportOrder::Default) const override;
 
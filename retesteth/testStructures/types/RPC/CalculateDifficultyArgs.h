@@ -0,0 +1,34 @@
+#pragma once
+#include "../../basetypes.h"
+
+namespace test
+{
+namespace teststruct
+{
+// Difficulty test vector sent to test_calculateDifficulty
+struct CalculateDifficultyArgs
+{
+    CalculateDifficultyArgs(VALUE const& _blockNumber, VALUE const& _parentTimestamp, VALUE const& _parentDifficulty,
+        VALUE const& _currentTimestamp, VALUE const& _uncleNumber)
+      : m_blockNumber(_blockNumber.copy()),
+        m_parentTimestamp(_parentTimestamp.copy()),
+        m_parentDifficulty(_parentDifficulty.copy()),
+        m_currentTimestamp(_currentTimestamp.copy()),
+        m_uncleNumber(_uncleNumber.copy())
+    {}
+    VALUE const& blockNumber() const { return m_blockNumber; }
+    VALUE const& parentTimestamp() const { return m_parentTimestamp; }
+    VALUE const& parentDifficulty() const { return m_parentDifficulty; }
+    VALUE const& currentTimestamp() const { return m_currentTimestamp; }
+    VALUE const& uncleNumber() const { return m_uncleNumber; }
+
+private:
+    spVALUE m_blockNumber;
+    spVALUE m_parentTimestamp;
+    spVALUE m_parentDifficulty;
+    spVALUE m_currentTimestamp;
+    spVALUE m_uncleNumber;
+};
+
+}  // namespace teststruct
+}  // namespace test
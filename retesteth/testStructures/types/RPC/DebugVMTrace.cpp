@@ -3,6 +3,48 @@
 #include <TestHelper.h>
 #include <dataObject/ConvertFile.h>
 #include <testStructures/Common.h>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+// Read the number field of the trace line without json parsing: "key":123 or "key":"0x7b"
+bool readNumberField(char const* _begin, char const* _end, string const& _key, uint64_t& _out)
+{
+    char const* pos = std::search(_begin, _end, _key.begin(), _key.end());
+    if (pos == _end)
+        return false;
+    pos += _key.size();
+    while (pos < _end && (*pos == ' ' || *pos == '"'))
+        pos++;
+
+    bool hex = false;
+    if (pos + 1 < _end && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X'))
+    {
+        hex = true;
+        pos += 2;
+    }
+
+    uint64_t value = 0;
+    bool digits = false;
+    for (; pos < _end; pos++)
+    {
+        int digit = -1;
+        if (*pos >= '0' && *pos <= '9')
+            digit = *pos - '0';
+        else if (hex && *pos >= 'a' && *pos <= 'f')
+            digit = *pos - 'a' + 10;
+        else if (hex && *pos >= 'A' && *pos <= 'F')
+            digit = *pos - 'A' + 10;
+        if (digit < 0)
+            break;
+        value = value * (hex ? 16 : 10) + digit;
+        digits = true;
+    }
+    _out = value;
+    return digits;
+}
+}  // namespace
 
 namespace test
 {
@@ -32,27 +74,112 @@ VMLogRecord::VMLogRecord(DataObject const& _obj)
     }
 }
 
-DebugVMTrace::DebugVMTrace(string const& _info, string const& _trNumber, FH32 const& _trHash, string const& _logs)
+VMTraceLog::VMTraceLog(fs::path const& _file) : m_file(new MappedFile(_file))
 {
-    try
+    m_data = m_file->data();
+    m_size = m_file->size();
+    indexLines();
+}
+
+VMTraceLog::VMTraceLog(string const& _logs) : m_buffer(_logs)
+{
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    indexLines();
+}
+
+VMTraceLog::~VMTraceLog() {}
+
+void VMTraceLog::indexLines()
+{
+    static string const c_pc = "\"pc\":";
+    static string const c_op = "\"op\":";
+    static string const c_gas = "\"gas\":";
+    static string const c_depth = "\"depth\":";
+
+    std::vector<uint64_t> lines;
+    size_t pos = 0;
+    while (pos < m_size)
     {
-        m_infoString = _info;
-        m_trNumber = _trNumber;
-        m_trHash = spFH32(_trHash.copy());
+        char const* eol = static_cast<char const*>(memchr(m_data + pos, '\n', m_size - pos));
+        size_t const next = eol ? eol - m_data + 1 : m_size;
+        size_t end = eol ? eol - m_data : m_size;
+        if (end > pos && m_data[end - 1] == '\r')
+            end--;
+        if (end > pos)
+            lines.push_back(pos);
+        pos = next;
+    }
+    if (lines.empty())
+        return;
 
-        auto logs = test::explode(_logs, '\n');
-        if (logs.size())
-        {
-            for (size_t i = 0; i < logs.size() - 1; i++)
-                m_log.push_back(VMLogRecord(ConvertJsoncppStringToData(logs.at(i))));
+    // Every line except the last one is an opcode step
+    size_t const steps = lines.size() - 1;
+    m_pc.reserve(steps);
+    m_op.reserve(steps);
+    m_gas.reserve(steps);
+    m_depth.reserve(steps);
+    for (size_t i = 0; i < steps; i++)
+    {
+        char const* begin = m_data + lines.at(i);
+        char const* end = m_data + lines.at(i + 1);
+        uint64_t pc, op, gas, depth;
+        if (!readNumberField(begin, end, c_pc, pc) || !readNumberField(begin, end, c_op, op) ||
+            !readNumberField(begin, end, c_gas, gas) || !readNumberField(begin, end, c_depth, depth))
+            throw UpwardsException("DebugVMTrace parse error: unexpected trace line: " + lineAt(lines.at(i), lines.at(i + 1)));
+        m_pc.push_back(pc);
+        m_op.push_back(op);
+        m_gas.push_back(gas);
+        m_depth.push_back(depth);
+    }
+    m_lineBegin = std::move(lines);
+}
 
-            spDataObject lastRecord = ConvertJsoncppStringToData(logs.at(logs.size() - 1));
-            m_output = lastRecord->atKey("output").asString();
-            m_gasUsed = spVALUE(new VALUE(lastRecord->atKey("gasUsed")));
-            m_time = lastRecord->atKey("time").asInt();
-        }
+string VMTraceLog::lineAt(size_t _begin, size_t _end) const
+{
+    while (_end > _begin && (m_data[_end - 1] == '\n' || m_data[_end - 1] == '\r'))
+        _end--;
+    return string(m_data + _begin, _end - _begin);
+}
 
-        m_rawUnparsedLogs = _logs;
+string VMTraceLog::line(size_t _step) const
+{
+    return lineAt(m_lineBegin.at(_step), m_lineBegin.at(_step + 1));
+}
+
+string VMTraceLog::summaryLine() const
+{
+    if (m_lineBegin.empty())
+        return string();
+    return lineAt(m_lineBegin.back(), m_size);
+}
+
+VMLogRecord VMTraceLog::record(size_t _step) const
+{
+    return VMLogRecord(ConvertJsoncppStringToData(line(_step)));
+}
+
+DebugVMTrace::DebugVMTrace() : m_log(new VMTraceLog(string())) {}
+
+DebugVMTrace::DebugVMTrace(string const& _info, string const& _trNumber, FH32 const& _trHash, string const& _logs)
+{
+    try
+    {
+        m_log = spVMTraceLog(new VMTraceLog(_logs));
+        init(_info, _trNumber, _trHash);
+    }
+    catch (std::exception const& _ex)
+    {
+        throw UpwardsException(string("DebugVMTrace parse error: ") + _ex.what());
+    }
+}
+
+DebugVMTrace::DebugVMTrace(string const& _info, string const& _trNumber, FH32 const& _trHash, fs::path const& _logFile)
+{
+    try
+    {
+        m_log = spVMTraceLog(new VMTraceLog(_logFile));
+        init(_info, _trNumber, _trHash);
     }
     catch (std::exception const& _ex)
     {
@@ -60,38 +187,62 @@ DebugVMTrace::DebugVMTrace(string const& _info, string const& _trNumber, FH32 co
     }
 }
 
+void DebugVMTrace::init(string const& _info, string const& _trNumber, FH32 const& _trHash)
+{
+    m_infoString = _info;
+    m_trNumber = _trNumber;
+    m_trHash = spFH32(_trHash.copy());
+
+    string const summary = m_log->summaryLine();
+    if (!summary.empty())
+    {
+        spDataObject lastRecord = ConvertJsoncppStringToData(summary);
+        m_output = lastRecord->atKey("output").asString();
+        m_gasUsed = spVALUE(new VALUE(lastRecord->atKey("gasUsed")));
+        m_time = lastRecord->atKey("time").asInt();
+    }
+}
+
 void DebugVMTrace::print()
 {
     ETH_LOG(m_infoString, 0);
-    ETH_LOG(m_rawUnparsedLogs, 0);
+    if (eth_getVerbosity() >= 0)
+    {
+        // Stream the raw file content instead of making a copy of it
+        std::cout.write(m_log->data(), m_log->dataSize());
+        std::cout << std::endl;
+    }
 }
 
 void DebugVMTrace::printNice()
 {
     ETH_LOG(m_infoString, 0);
-    if (m_log.size() == 0)
+    VMTraceLog const& log = m_log;
+    if (log.size() == 0)
         return;
 
     string s_comment = "";
-    dev::bigint maxGas = m_log.at(0).gas->asBigInt();
-    size_t k = 0;
+    uint64_t const maxGas = log.gas(0);
     size_t const step = 9;
     string const stepw = "          ";
     std::cout << test::cBYellowBlack << "N" << setw(15) << "OPNAME" << setw(10) << "GASCOST" << setw(10) << "TOTALGAS"
               << setw(10) << "REMAINGAS" << setw(20) << "ERROR" << test::cDefault << std::endl;
-    for (VMLogRecord const& el : m_log)
+    for (size_t k = 0; k < log.size(); k++)
     {
+        // Records are parsed one by one, so the trace is never held in memory as a whole
+        VMLogRecord const el = log.record(k);
+        size_t const depth = log.depth(k);
         if (!s_comment.empty())
         {
-            std::cout << setw(step * el.depth) << test::cYellow << s_comment << test::cDefault << std::endl;
+            std::cout << setw(step * depth) << test::cYellow << s_comment << test::cDefault << std::endl;
             s_comment = string();
         }
-        std::cout << setw(step * (el.depth - 1));
-        std::cout << test::fto_string(k++) + "-" + test::fto_string(el.depth)
+        std::cout << setw(step * (depth - 1));
+        std::cout << test::fto_string(k) + "-" + test::fto_string(depth)
                   << setw(15) << el.opName
                   << setw(10) << el.gasCost->asDecString()
-                  << setw(10) << maxGas - el.gas->asBigInt()
-                  << setw(10) << el.gas->asDecString()
+                  << setw(10) << maxGas - log.gas(k)
+                  << setw(10) << log.gas(k)
                   << setw(20) << el.error << std::endl;
 
         // Opcode highlight
@@ -1,11 +1,16 @@
 #pragma once
 #include "../../basetypes.h"
 #include <retesteth/dataObject/DataObject.h>
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <memory>
 
 using namespace dataobject;
+namespace fs = boost::filesystem;
 
 namespace test
 {
+class MappedFile;
 namespace teststruct
 {
 /*
@@ -32,19 +37,64 @@ struct VMLogRecord
     string error;
 };
 
+// Jsonl trace lines of one transaction. The trace file is memory mapped and indexed by line
+// VMLogRecord is parsed on demand, only pc/op/gas/depth of each step are kept in compact columns
+class VMTraceLog : public GCP_SPointerBase
+{
+public:
+    VMTraceLog(fs::path const& _file);
+    VMTraceLog(string const& _logs);
+    VMTraceLog(VMTraceLog const&) = delete;
+    VMTraceLog& operator=(VMTraceLog const&) = delete;
+    ~VMTraceLog();
+
+    // Number of opcode steps (the summary line is not counted)
+    size_t size() const { return m_pc.size(); }
+    VMLogRecord record(size_t _step) const;
+    string line(size_t _step) const;
+    string summaryLine() const;
+
+    uint32_t pc(size_t _step) const { return m_pc.at(_step); }
+    uint8_t op(size_t _step) const { return m_op.at(_step); }
+    uint64_t gas(size_t _step) const { return m_gas.at(_step); }
+    uint16_t depth(size_t _step) const { return m_depth.at(_step); }
+
+    char const* data() const { return m_data; }
+    size_t dataSize() const { return m_size; }
+
+private:
+    void indexLines();
+    string lineAt(size_t _begin, size_t _end) const;
+
+    char const* m_data = nullptr;
+    size_t m_size = 0;
+    std::unique_ptr<MappedFile> m_file;
+    string m_buffer;
+
+    // m_lineBegin has size() + 1 elements, the last one is the summary line
+    std::vector<uint64_t> m_lineBegin;
+    std::vector<uint32_t> m_pc;
+    std::vector<uint8_t> m_op;
+    std::vector<uint64_t> m_gas;
+    std::vector<uint16_t> m_depth;
+};
+typedef GCP_SPointer<VMTraceLog> spVMTraceLog;
+
 struct DebugVMTrace
 {
-    DebugVMTrace() {}  // for tuples
+    DebugVMTrace();  // for tuples
     DebugVMTrace(string const& _info, string const& _trNumber, FH32 const& _trHash, string const& _logs);
+    DebugVMTrace(string const& _info, string const& _trNumber, FH32 const& _trHash, fs::path const& _logFile);
     void print();
     void printNice();
+    VMTraceLog const& log() const { return m_log; }
 
 private:
+    void init(string const& _info, string const& _trNumber, FH32 const& _trHash);
     string m_infoString;
     string m_trNumber;
     spFH32 m_trHash;
-    std::vector<VMLogRecord> m_log;
-    string m_rawUnparsedLogs;
+    spVMTraceLog m_log;
 
     // Last record
     string m_output;
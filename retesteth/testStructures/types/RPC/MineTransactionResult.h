@@ -0,0 +1,31 @@
+#pragma once
+#include "../../basetypes.h"
+#include "EthGetBlockBy.h"
+#include "MineBlocksResult.h"
+#include <retesteth/dataObject/DataObject.h>
+
+using namespace dataobject;
+
+namespace test
+{
+namespace teststruct
+{
+// Structure for response of test_mineTransactionsBatch
+// Each transaction is mined in its own block on top of the genesis
+struct MineTransactionResult
+{
+    MineTransactionResult(MineBlocksResult const& _mineResult, EthGetBlockBy const& _block, FH32 const& _logHash)
+      : m_mineResult(_mineResult), m_block(_block), m_logHash(_logHash.copy())
+    {}
+    MineBlocksResult const& mineResult() const { return m_mineResult; }
+    EthGetBlockBy const& block() const { return m_block; }
+    FH32 const& logHash() const { return m_logHash; }
+
+private:
+    MineBlocksResult m_mineResult;
+    EthGetBlockBy m_block;
+    spFH32 m_logHash;
+};
+
+}  // namespace teststruct
+}  // namespace test
@@ -1,9 +1,11 @@
 #pragma once
+#include "RPC/CalculateDifficultyArgs.h"
 #include "RPC/DebugAccountRange.h"
 #include "RPC/DebugStorageRangeAt.h"
 #include "RPC/DebugTraceTransaction.h"
 #include "RPC/DebugVMTrace.h"
 #include "RPC/EthGetBlockBy.h"
 #include "RPC/MineBlocksResult.h"
+#include "RPC/MineTransactionResult.h"
 #include "RPC/SetChainParamsArgs.h"
 #include "RPC/TestRawTranasction.h"
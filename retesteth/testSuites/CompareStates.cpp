@@ -1,38 +1,13 @@
 #include "Common.h"
+#include <libdevcore/Common.h>
 #include <retesteth/Options.h>
+#include <retesteth/session/RangePage.h>
 #include <retesteth/testStructures/types/Ethereum/State.h>
 using namespace std;
 namespace test
 {
 
-CompareResult compareAccounts(AccountBase const& _expectAccount, State::Account const& _remoteAccount);
-
-State::Account remoteGetAccount(SessionInterface& _session, VALUE const& _bNumber, VALUE const& _trIndex, FH20 const& _account)
-{
-    // TODO make sp here. do not copy returned data
-    // Read the returned memory and put it in the account
-    spVALUE balance = _session.eth_getBalance(_account, _bNumber);
-    spVALUE nonce = _session.eth_getTransactionCount(_account, _bNumber);
-    spBYTES code = _session.eth_getCode(_account, _bNumber);
-
-    bool hasStorage = true;
-    FH32 beginHash = FH32::zero();
-    spStorage tmpStorage = spStorage(new Storage(DataObject(DataType::Object)));
-    size_t safety = 500;
-    while (hasStorage && --safety)
-    {
-        // Read storage from remote account by 20 records at a time
-        DebugStorageRangeAt res(_session.debug_storageRangeAt(_bNumber, _trIndex, _account, beginHash, 20));
-        if (res.nextKey().isZero())
-            hasStorage = false;
-        else
-            beginHash = res.nextKey();
-        (*tmpStorage).merge(res.storage());
-    }
-    if (safety == 0)
-        ETH_ERROR_MESSAGE("remoteGetAccount::DebugStorageRangeAt seems like an endless loop!");
-    return State::Account(_account, balance, nonce, code, tmpStorage);
-}
+CompareResult compareAccounts(AccountBase const& _expectAccount, AccountBase const& _remoteAccount);
 
 // Get full remote state from the client
 State getRemoteState(SessionInterface& _session)
@@ -41,12 +16,14 @@ State getRemoteState(SessionInterface& _session)
     EthGetBlockBy recentBlock(_session.eth_getBlockByNumber(recentBNumber, Request::LESSOBJECTS));
     VALUE trIndex(recentBlock.transactions().size());
 
-    // Construct accountList by asking packs of 10th of accounts from remote client
+    // Construct accountList by asking pages of accounts from remote client
     std::vector<FH20> accountList;
+    RangePage page(10);
     FH32 nextKey("0x0000000000000000000000000000000000000000000000000000000000000001");
     while (!nextKey.isZero())
     {
-        DebugAccountRange range(_session.debug_accountRange(recentBNumber, trIndex, nextKey, 10));
+        dev::Timer timer;
+        DebugAccountRange range(_session.debug_accountRange(recentBNumber, trIndex, nextKey, page.size()));
         for (auto const& el : range.addresses())
         {
             accountList.push_back(el);
@@ -54,23 +31,22 @@ State getRemoteState(SessionInterface& _session)
                 throw StateTooBig();
         }
         nextKey = range.nextKey();
+        page.update(!nextKey.isZero(), timer.elapsed());
     }
 
-    // Use recentBNumber and trIndex once to request account information in loop
-    auto getRemoteAccount = [&_session, &recentBNumber, &trIndex](
-                                FH20 const& _account) { return remoteGetAccount(_session, recentBNumber, trIndex, _account); };
-
+    // Account fields and storage of all accounts are requested in batches
+    // The session stops reading storage pages once the state is over the limit
+    size_t const sizeLimit = Options::get().fullstate ? 0 : 1048510;  // 1MB
     size_t byteSize = 0;
     std::map<FH20, spAccountBase> stateAccountMap;
-    for (auto const& acc : accountList)
+    for (auto const& remAccount : _session.debug_getAccountsBatch(recentBNumber, trIndex, accountList, sizeLimit))
     {
-        spAccountBase remAccount(new State::Account(getRemoteAccount(acc)));
-        stateAccountMap.emplace(acc, remAccount);
-        if (!Options::get().fullstate)
+        stateAccountMap.emplace(remAccount->address(), remAccount);
+        if (sizeLimit != 0)
         {
             byteSize += remAccount->storage().getKeys().size() * 64;
             byteSize += remAccount->code().asString().size() / 2;
-            if (byteSize > 1048510) // 1MB
+            if (byteSize > sizeLimit)
                 throw StateTooBig();
         }
     }
@@ -86,21 +62,21 @@ void compareStates(StateBase const& _stateExpect, SessionInterface& _session)
     EthGetBlockBy recentBlock(_session.eth_getBlockByNumber(recentBNumber, Request::LESSOBJECTS));
     VALUE trIndex(recentBlock.transactions().size());
 
-    // Use recentBNumber and trIndex once to request account information in loop
-    auto getRemoteAccount = [&_session, &recentBNumber, &trIndex](
-                                FH20 const& _account) { return remoteGetAccount(_session, recentBNumber, trIndex, _account); };
-
-    // Construct accountList by asking packs of 10th of accounts from remote client
+    // Construct accountList by asking pages of accounts from remote client
     std::set<FH20> remoteAccountList;
+    RangePage page(10);
     FH32 nextKey("0x0000000000000000000000000000000000000000000000000000000000000001");
     while (!nextKey.isZero())
     {
-        DebugAccountRange range(_session.debug_accountRange(recentBNumber, trIndex, nextKey, 10));
+        dev::Timer timer;
+        DebugAccountRange range(_session.debug_accountRange(recentBNumber, trIndex, nextKey, page.size()));
         for (auto const& el : range.addresses())
             remoteAccountList.insert(el);
         nextKey = range.nextKey();
+        page.update(!nextKey.isZero(), timer.elapsed());
     }
 
+    std::vector<FH20> compareList;
     for (auto const& ael : _stateExpect.accounts())
     {
         AccountBase const& a = ael.second.getCContent();
@@ -119,9 +95,15 @@ void compareStates(StateBase const& _stateExpect, SessionInterface& _session)
         }
         else if (a.shouldNotExist() && !remoteHasAccount)
             continue;
+        compareList.push_back(a.address());
+    }
 
-        // Compare account in postState with expect section account
-        CompareResult accountCompareResult = compareAccounts(a, getRemoteAccount(a.address()));
+    // Compare accounts in postState with expect section accounts, remote accounts are requested in batches
+    std::vector<spAccountBase> const remoteAccounts = _session.debug_getAccountsBatch(recentBNumber, trIndex, compareList, 0);
+    for (size_t i = 0; i < compareList.size(); i++)
+    {
+        AccountBase const& a = _stateExpect.accounts().at(compareList.at(i)).getCContent();
+        CompareResult accountCompareResult = compareAccounts(a, remoteAccounts.at(i).getCContent());
         if (accountCompareResult != CompareResult::Success)
             result = accountCompareResult;
     }
@@ -180,7 +162,7 @@ CompareResult compareStorage(Storage const& _expectStorage, Storage const& _remo
 
 // TODO make a friend with Account class ?
 // Compare Expected Account agains Account
-CompareResult compareAccounts(AccountBase const& _expectAccount, State::Account const& _remoteAccount)
+CompareResult compareAccounts(AccountBase const& _expectAccount, AccountBase const& _remoteAccount)
 {
     // report all errors, but return the last error as a compare result
     CompareResult result = CompareResult::Success;
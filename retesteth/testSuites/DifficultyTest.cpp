@@ -15,18 +15,15 @@ namespace fs = boost::filesystem;
 namespace
 {
 
-spDataObject makeTest(FORK const& _fork, VALUE const& _bn, VALUE const& _td, VALUE const& _pd, VALUE const& _un)
+spDataObject makeTest(CalculateDifficultyArgs const& _args, VALUE const& _res)
 {
     spDataObject test;
-    SessionInterface& session = RPCSession::instance(TestOutputHelper::getThreadID());
-
-    VALUE const res = session.test_calculateDifficulty(_fork, _bn, 0, _pd, _td, _un);
     (*test)["parentTimestamp"] = "0x00";
-    (*test)["parentUncles"] = _un.asString();
-    (*test)["parentDifficulty"] = _pd.asString();
-    (*test)["currentTimestamp"] = _td.asString();
-    (*test)["currentBlockNumber"] = _bn.asString();
-    (*test)["currentDifficulty"] = res.asString();
+    (*test)["parentUncles"] = _args.uncleNumber().asString();
+    (*test)["parentDifficulty"] = _args.parentDifficulty().asString();
+    (*test)["currentTimestamp"] = _args.currentTimestamp().asString();
+    (*test)["currentBlockNumber"] = _args.blockNumber().asString();
+    (*test)["currentDifficulty"] = _res.asString();
     return test;
 }
 
@@ -51,20 +48,22 @@ spDataObject FillTest(DifficultyTestInFiller const& _test)
         if (networkSkip)
             continue;
 
-        spDataObject filledTestNetwork;
+        std::vector<CalculateDifficultyArgs> args;
         for (auto const& bn : _test.blocknumbers().vector())
-        {
             for (auto const& td : _test.timestumps().vector())
-            {
                 for (auto const& pd : _test.parentdiffs().vector())
-                {
                     for (auto const& un : _test.uncles())
-                    {
-                        string const testname = _test.testName() + "-" + test::fto_string(i++);
-                        (*filledTestNetwork).atKeyPointer(testname) = makeTest(fork, bn, td, pd, un);
-                    }
-                }
-            }
+                        args.emplace_back(bn, 0, pd, td, un);
+
+        // The whole grid of the network is calculated in one request
+        SessionInterface& session = RPCSession::instance(TestOutputHelper::getThreadID());
+        std::vector<VALUE> const results = session.test_calculateDifficulty(fork, args);
+
+        spDataObject filledTestNetwork;
+        for (size_t j = 0; j < args.size(); j++)
+        {
+            string const testname = _test.testName() + "-" + test::fto_string(i++);
+            (*filledTestNetwork).atKeyPointer(testname) = makeTest(args.at(j), results.at(j));
         }
 
         (*filledTest).atKeyPointer(fork.asString()) = filledTestNetwork;
@@ -79,10 +78,16 @@ void RunTest(DifficultyTestInFilled const& _test)
 
     for (auto const& v : _test.testVectors())
     {
+        std::vector<CalculateDifficultyArgs> args;
         for (auto const& el : v.second)
+            args.emplace_back(
+                el.currentBlockNumber, el.parentTimestamp, el.parentDifficulty, el.currentTimestamp, el.parentUncles);
+
+        std::vector<VALUE> const results = session.test_calculateDifficulty(v.first, args);
+        for (size_t i = 0; i < v.second.size(); i++)
         {
-            VALUE const res = session.test_calculateDifficulty(
-                v.first, el.currentBlockNumber, el.parentTimestamp, el.parentDifficulty, el.currentTimestamp, el.parentUncles);
+            auto const& el = v.second.at(i);
+            VALUE const& res = results.at(i);
             ETH_ERROR_REQUIRE_MESSAGE(res == el.currentDifficulty, _test.testName() + "/" + el.testVectorName +
                                                                        " difficulty mismatch got: `" + res.asDecString() +
                                                                        ", test want: `" + el.currentDifficulty->asDecString());
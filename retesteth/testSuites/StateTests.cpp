@@ -29,12 +29,14 @@
 #include <dataObject/DataObject.h>
 #include <libdevcore/CommonData.h>
 #include <libdevcore/CommonIO.h>
+#include <retesteth/ExecTimeStats.h>
 #include <retesteth/ExitHandler.h>
 #include <retesteth/Options.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/TestSuite.h>
 #include <retesteth/session/Session.h>
+#include <retesteth/session/ThreadManager.h>
 #include <retesteth/testStructures/Common.h>
 #include <retesteth/testStructures/PrepareChainParams.h>
 #include <retesteth/testStructures/structures.h>
@@ -93,6 +95,36 @@ void checkUnexecutedTransactions(std::vector<TransactionInGeneralSection> const&
 }
 
 
+// Chain params and inputs of one fork, prepared on the thread that parsed the test
+// Forks could run on idle threads as units that share the parsed test. Sections with lazily
+// cached fields (pre, env, transactions, expect results) are read on the parsing thread only
+struct StateTestFork
+{
+    StateTestFork(FORK const& _network) : network(_network) {}
+    FORK network;
+    bool networkSkip = false;
+    bool forkNotAllowed = false;
+    spSetChainParamsArgs params;
+    spVALUE timestamp;
+    std::vector<GCP_SPointer<StateIncomplete>> expectResults;  // copies of the expect results for a unit
+};
+
+// Mark the transactions that were executed or skipped by any of the fork units
+void mergeUnitTransactions(std::vector<TransactionInGeneralSection>& _txs,
+    std::vector<std::vector<TransactionInGeneralSection>> const& _unitTxs)
+{
+    for (auto const& unitTxs : _unitTxs)
+    {
+        for (size_t k = 0; k < _txs.size() && k < unitTxs.size(); k++)
+        {
+            if (unitTxs.at(k).getExecuted())
+                _txs.at(k).markExecuted();
+            if (unitTxs.at(k).getSkipped())
+                _txs.at(k).markSkipped();
+        }
+    }
+}
+
 /// Generate a blockchain test from state test filler
 spDataObject FillTestAsBlockchain(StateTestInFiller const& _test)
 {
@@ -209,14 +241,144 @@ spDataObject FillTestAsBlockchain(StateTestInFiller const& _test)
     return filledTest;
 }
 
+/// Fill the post results of one fork
+spDataObject FillTestFork(StateTestInFiller const& _test, StateTestFork const& _fork,
+    std::vector<TransactionInGeneralSection>& _txs)
+{
+    SessionInterface& session = RPCSession::instance(TestOutputHelper::getThreadID());
+    FORK const& fork = _fork.network;
+    spDataObject forkResults;
+    (*forkResults).setKey(fork.asString());
+    session.test_setChainParams(_fork.params);
+
+    // Run transactions for defined expect sections only
+    for (size_t expectID = 0; expectID < _test.Expects().size(); expectID++)
+    {
+        // if expect section for this networks
+        StateTestFillerExpectSection const& expect = _test.Expects().at(expectID);
+        if (expect.hasFork(fork))
+        {
+            StateIncomplete const& expectResult =
+                _fork.expectResults.empty() ? expect.result() : _fork.expectResults.at(expectID).getCContent();
+            bool expectFoundTransaction = false;
+            for (auto& tr : _txs)
+            {
+                TestInfo errorInfo(fork.asString(), tr.dataInd(), tr.gasInd(), tr.valueInd());
+                if (!tr.transaction()->dataLabel().empty() || !tr.transaction()->dataRawPreview().empty())
+                    errorInfo.setTrDataDebug(tr.transaction()->dataLabel() + " " + tr.transaction()->dataRawPreview() + "..");
+
+                TestOutputHelper::get().setCurrentTestInfo(errorInfo);
+
+                bool expectChekIndexes = expect.checkIndexes(tr.dataInd(), tr.gasInd(), tr.valueInd());
+                if (!OptionsAllowTransaction(tr) || _fork.networkSkip)
+                {
+                    tr.markSkipped();
+
+                    if (expectChekIndexes)
+                        expectFoundTransaction = true;
+                    continue;
+                }
+
+                // if expect section is not for this transaction
+                if (!expectChekIndexes)
+                    continue;
+
+                expectFoundTransaction = true;
+                session.test_modifyTimestamp(_fork.timestamp);
+                FH32 trHash(session.eth_sendRawTransaction(tr.transaction()->getRawBytes(), tr.transaction()->getSecret()));
+
+                MineBlocksResult const mRes = session.test_mineBlocks(1);
+                string const& testException = expect.getExpectException(fork);
+                compareTransactionException(tr.transaction(), mRes, testException);
+
+                VALUE latestBlockN(session.eth_blockNumber());
+                EthGetBlockBy blockInfo(session.eth_getBlockByNumber(latestBlockN, Request::LESSOBJECTS));
+                if (!blockInfo.hasTransaction(trHash) && testException.empty())
+                    ETH_ERROR_MESSAGE("StateTest::FillTest: " + c_trHashNotFound);
+                tr.markExecuted();
+
+                if (Options::get().poststate)
+                    ETH_STDOUT_MESSAGE("PostState " + TestOutputHelper::get().testInfo().errorDebug() + " : \n" + cDefault +
+                                       "Hash: " + blockInfo.header()->stateRoot().asString());
+
+                if (Options::get().vmtrace)
+                    printVmTrace(session, trHash, blockInfo.header()->stateRoot());
+                try
+                {
+                    compareStates(expectResult, getRemoteState(session));
+                }
+                catch(StateTooBig const&)
+                {
+                    compareStates(expectResult, session);
+                }
+
+                spDataObject indexes;
+                spDataObject transactionResults;
+                (*indexes)["data"] = tr.dataInd();
+                (*indexes)["gas"] = tr.gasInd();
+                (*indexes)["value"] = tr.valueInd();
+
+                (*transactionResults).atKeyPointer("indexes") = indexes;
+                (*transactionResults)["hash"] = blockInfo.header()->stateRoot().asString();
+                (*transactionResults)["txbytes"] = tr.transaction()->getRawBytes().asString();
+                if (!testException.empty())
+                    (*transactionResults)["expectException"] = testException;
+
+                // Fill up the loghash (optional)
+                if (Options::getDynamicOptions().getCurrentConfig().cfgFile().checkLogsHash())
+                {
+                    FH32 logHash(session.test_getLogHash(trHash));
+                    if (!logHash.isZero())
+                        (*transactionResults)["logs"] = logHash.asString();
+                }
+
+                (*forkResults).addArrayObject(transactionResults);
+                session.test_rewindToBlock(VALUE(0));
+            }
+            if (expectFoundTransaction == false)
+            {
+                ETH_ERROR_MESSAGE("Expect section does not cover any transaction: \n" + expect.initialData().asJson() +
+                                  "\n" + expectResult.asDataObject()->asJson());
+            }
+        }
+    }
+
+    return forkResults;
+}
+
+StateTestFork prepareFillFork(StateTestInFiller const& _test, FORK const& _network, bool _copyExpects)
+{
+    // Skip by --singlenet option
+    StateTestFork fork(_network);
+    Options const& opt = Options::get();
+    if ((!opt.singleTestNet.empty() && FORK(opt.singleTestNet) != _network) ||
+        !Options::getDynamicOptions().getCurrentConfig().checkForkAllowed(_network))
+        fork.networkSkip = true;
+
+    fork.params = prepareChainParams(_network, SealEngine::NoReward, _test.Pre(), _test.Env(), ParamsContext::StateTests);
+    fork.timestamp = spVALUE(_test.Env().firstBlockTimestamp().copy());
+    if (_copyExpects)
+    {
+        for (auto const& expect : _test.Expects())
+        {
+            if (!expect.hasFork(_network))
+            {
+                fork.expectResults.push_back(GCP_SPointer<StateIncomplete>(0));
+                continue;
+            }
+            spDataObject data = expect.result().rawData()->copy();
+            fork.expectResults.push_back(GCP_SPointer<StateIncomplete>(new StateIncomplete(dataobject::move(data))));
+        }
+    }
+    return fork;
+}
+
 /// Rewrite the test file. Fill General State Test
 spDataObject FillTest(StateTestInFiller const& _test)
 {
     spDataObject filledTest;
     TestOutputHelper::get().setCurrentTestName(_test.testName());
 
-    SessionInterface& session = RPCSession::instance(TestOutputHelper::getThreadID());
-
     if (_test.hasInfo())
         (*filledTest).atKeyPointer("_info") = _test.Info().rawData();
     (*filledTest).atKeyPointer("env") = _test.Env().asDataObject();
@@ -238,129 +400,119 @@ spDataObject FillTest(StateTestInFiller const& _test)
     }
 
     // run transactions on all networks that we need
-    for (auto const& fork : _test.getAllForksFromExpectSections())  // object constructed!!!
+    std::set<FORK> const forks = _test.getAllForksFromExpectSections();
+    Options const& opt = Options::get();
+    bool const splitByForks = forks.size() > 1 && !opt.vmtrace && !opt.poststate && ThreadManager::canSplitTasks();
+    if (splitByForks)
     {
-        // Skip by --singlenet option
-        bool networkSkip = false;
-        Options const& opt = Options::get();
-
-        if ((!opt.singleTestNet.empty() && FORK(opt.singleTestNet) != fork) ||
-            !Options::getDynamicOptions().getCurrentConfig().checkForkAllowed(fork))
-            networkSkip = true;
-
-        spDataObject forkResults;
-        (*forkResults).setKey(fork.asString());
-
-        auto const p = prepareChainParams(fork, SealEngine::NoReward, _test.Pre(), _test.Env(), ParamsContext::StateTests);
-        session.test_setChainParams(p);
-
-        // Run transactions for defined expect sections only
-        for (auto const& expect : _test.Expects())
+        // Forks are filled as units on idle threads, the results are added in the fork order
+        std::vector<StateTestFork> preparedForks;
+        std::vector<std::vector<TransactionInGeneralSection>> unitTxs;
+        for (auto const& fork : forks)
         {
-            // if expect section for this networks
-            if (expect.hasFork(fork))
-            {
-                bool expectFoundTransaction = false;
-                for (auto& tr : txs)
-                {
-                    TestInfo errorInfo(fork.asString(), tr.dataInd(), tr.gasInd(), tr.valueInd());
-                    if (!tr.transaction()->dataLabel().empty() || !tr.transaction()->dataRawPreview().empty())
-                        errorInfo.setTrDataDebug(tr.transaction()->dataLabel() + " " + tr.transaction()->dataRawPreview() + "..");
-
-                    TestOutputHelper::get().setCurrentTestInfo(errorInfo);
-
-                    bool expectChekIndexes = expect.checkIndexes(tr.dataInd(), tr.gasInd(), tr.valueInd());
-                    if (!OptionsAllowTransaction(tr) || networkSkip)
-                    {
-                        tr.markSkipped();
-
-                        if (expectChekIndexes)
-                            expectFoundTransaction = true;
-                        continue;
-                    }
-
-                    // if expect section is not for this transaction
-                    if (!expectChekIndexes)
-                        continue;
-
-                    expectFoundTransaction = true;
-                    session.test_modifyTimestamp(_test.Env().firstBlockTimestamp());
-                    FH32 trHash(session.eth_sendRawTransaction(tr.transaction()->getRawBytes(), tr.transaction()->getSecret()));
-
-                    MineBlocksResult const mRes = session.test_mineBlocks(1);
-                    string const& testException = expect.getExpectException(fork);
-                    compareTransactionException(tr.transaction(), mRes, testException);
+            preparedForks.push_back(prepareFillFork(_test, fork, true));
+            unitTxs.push_back(_test.GeneralTr().buildTransactions());
+        }
 
-                    VALUE latestBlockN(session.eth_blockNumber());
-                    EthGetBlockBy blockInfo(session.eth_getBlockByNumber(latestBlockN, Request::LESSOBJECTS));
-                    if (!blockInfo.hasTransaction(trHash) && testException.empty())
-                        ETH_ERROR_MESSAGE("StateTest::FillTest: " + c_trHashNotFound);
-                    tr.markExecuted();
+        std::vector<spDataObject> unitResults(preparedForks.size());
+        std::vector<std::function<void()>> units;
+        for (size_t i = 0; i < preparedForks.size(); i++)
+        {
+            units.push_back([&_test, &preparedForks, &unitTxs, &unitResults, i]() {
+                unitResults.at(i) = FillTestFork(_test, preparedForks.at(i), unitTxs.at(i));
+            });
+        }
+        ThreadManager::runUnits(units);
 
-                    if (Options::get().poststate)
-                        ETH_STDOUT_MESSAGE("PostState " + TestOutputHelper::get().testInfo().errorDebug() + " : \n" + cDefault +
-                                           "Hash: " + blockInfo.header()->stateRoot().asString());
+        for (auto const& forkResults : unitResults)
+            if (forkResults->getSubObjects().size() > 0)
+                (*filledTest)["post"].addSubObject(forkResults);
+        mergeUnitTransactions(txs, unitTxs);
+    }
+    else
+    {
+        for (auto const& fork : forks)
+        {
+            spDataObject const forkResults = FillTestFork(_test, prepareFillFork(_test, fork, false), txs);
+            if (forkResults->getSubObjects().size() > 0)
+                (*filledTest)["post"].addSubObject(forkResults);
+        }
+    }
 
-                    if (Options::get().vmtrace)
-                        printVmTrace(session, trHash, blockInfo.header()->stateRoot());
-                    try
-                    {
-                        compareStates(expect.result(), getRemoteState(session));
-                    }
-                    catch(StateTooBig const&)
-                    {
-                        compareStates(expect.result(), session);
-                    }
+    checkUnexecutedTransactions(txs);
+    return filledTest;
+}
 
-                    spDataObject indexes;
-                    spDataObject transactionResults;
-                    (*indexes)["data"] = tr.dataInd();
-                    (*indexes)["gas"] = tr.gasInd();
-                    (*indexes)["value"] = tr.valueInd();
+// Transaction of a fork that is expected to produce the post result
+struct StateTestJob
+{
+    StateTestPostResult const* result;
+    TransactionInGeneralSection* tr;
+};
 
-                    (*transactionResults).atKeyPointer("indexes") = indexes;
-                    (*transactionResults)["hash"] = blockInfo.header()->stateRoot().asString();
-                    (*transactionResults)["txbytes"] = tr.transaction()->getRawBytes().asString();
-                    if (!testException.empty())
-                        (*transactionResults)["expectException"] = testException;
+void setStateTestInfo(FORK const& _network, TransactionInGeneralSection const& _tr)
+{
+    TestInfo errorInfo(_network.asString(), _tr.dataInd(), _tr.gasInd(), _tr.valueInd());
+    errorInfo.setTrDataDebug(_tr.transaction()->dataLabel() + " " + _tr.transaction()->dataRawPreview() + "..");
+    TestOutputHelper::get().setCurrentTestInfo(errorInfo);
+}
 
-                    // Fill up the loghash (optional)
-                    if (Options::getDynamicOptions().getCurrentConfig().cfgFile().checkLogsHash())
-                    {
-                        FH32 logHash(session.test_getLogHash(trHash));
-                        if (!logHash.isZero())
-                            (*transactionResults)["logs"] = logHash.asString();
-                    }
+// Validate the transaction execution result against the post section
+// Remote state is inspected only if the client is still at the block of this transaction (not batched)
+void checkStateTestResult(SessionInterface& _session, StateTestPostResult const& _result,
+    TransactionInGeneralSection& _tr, MineTransactionResult const& _res)
+{
+    FH32 const& trHash = _tr.transaction()->hash();
+    string const& testException = _result.expectException();
+    compareTransactionException(_tr.transaction(), _res.mineResult(), testException);
+
+    EthGetBlockBy const& blockInfo = _res.block();
+    if (!blockInfo.hasTransaction(trHash) && testException.empty())
+        ETH_ERROR_MESSAGE("StateTest::RunTest: " + c_trHashNotFound);
+    _tr.markExecuted();
+
+    // Validate post state
+    FH32 const& expectedPostHash = _result.hash();
+    if (Options::get().vmtrace && !Options::get().filltests)
+        printVmTrace(_session, trHash, blockInfo.header()->stateRoot());
+
+    FH32 const& actualHash = blockInfo.header()->stateRoot();
+    if (actualHash != expectedPostHash)
+    {
+        if (Options::get().logVerbosity >= 5)
+            ETH_LOG("\nState Dump: \n" + getRemoteState(_session).asDataObject()->asJson(), 5);
+        ETH_ERROR_MESSAGE("Post hash mismatch remote: " + actualHash.asString() +
+                          ", expected: " + expectedPostHash.asString());
+    }
+    if (Options::get().poststate)
+        ETH_LOG("\nRunning test State Dump:" + TestOutputHelper::get().testInfo().errorDebug() + cDefault + " \n" + getRemoteState(_session).asDataObject()->asJson(), 1);
 
-                    (*forkResults).addArrayObject(transactionResults);
-                    session.test_rewindToBlock(VALUE(0));
-                }
-                if (expectFoundTransaction == false)
-                {
-                    ETH_ERROR_MESSAGE("Expect section does not cover any transaction: \n" + expect.initialData().asJson() +
-                                      "\n" + expect.result().asDataObject()->asJson());
-                }
-            }
-        }
+    // Validate that txbytes field has the transaction data described in test `transaction` field.
+    spBYTES const& expectedBytesPtr = _result.bytesPtr();
+    if (!expectedBytesPtr.isEmpty())
+    {
+        if (_tr.transaction()->getRawBytes().asString() != expectedBytesPtr->asString())
+            ETH_ERROR_MESSAGE("TxBytes mismatch: test transaction section doest not match txbytes in post section!");
+    }
 
-        if (forkResults->getSubObjects().size() > 0)
-            (*filledTest)["post"].addSubObject(forkResults);
+    // Validate log hash
+    if (Options::getDynamicOptions().getCurrentConfig().cfgFile().checkLogsHash())
+    {
+        FH32 const& expectedLogHash = _result.logs();
+        FH32 const& remoteLogHash = _res.logHash();
+        if (remoteLogHash != expectedLogHash)
+            ETH_ERROR_MESSAGE("Logs hash mismatch: '" + remoteLogHash.asString() + "', expected: '" +
+                              expectedLogHash.asString() + "'");
     }
 
-    checkUnexecutedTransactions(txs);
-    return filledTest;
+    if (Options::get().logVerbosity >= 5)
+        ETH_LOG("Executed: d: " + to_string(_tr.dataInd()) + ", g: " + to_string(_tr.gasInd()) +
+                    ", v: " + to_string(_tr.valueInd()) + ", fork: " + TestOutputHelper::get().testInfo().errorDebug(), 5);
 }
 
-/// Read and execute the test file
-void RunTest(StateTestInFilled const& _test)
+// Gather Transactions from general transaction section
+std::vector<TransactionInGeneralSection> buildRunTransactions(StateTestInFilled const& _test)
 {
-    if (ExitHandler::receivedExitSignal())
-        return;
-
-    TestOutputHelper::get().setCurrentTestName(_test.testName());
-    SessionInterface& session = RPCSession::instance(TestOutputHelper::getThreadID());
-
-    // Gather Transactions from general transaction section
     std::vector<TransactionInGeneralSection> txs = _test.GeneralTr().buildTransactions();
 
     // Recover transaction labels from filled test _info section
@@ -375,120 +527,162 @@ void RunTest(StateTestInFilled const& _test)
         else
             ETH_WARNING("Test `_info` section has a label with tr.index that was not found!");
     }
+    return txs;
+}
 
+StateTestFork prepareRunFork(StateTestInFilled const& _test, FORK const& _network)
+{
+    // If options singlenet select different network or test has network that is not allowed by clinet configs
+    StateTestFork fork(_network);
+    Options const& opt = Options::get();
+    if (!opt.singleTestNet.empty() && FORK(opt.singleTestNet) != _network)
+        fork.networkSkip = true;
+    else if (!Options::getDynamicOptions().getCurrentConfig().checkForkAllowed(_network))
+    {
+        fork.networkSkip = true;
+        fork.forkNotAllowed = true;
+        ETH_WARNING("Skipping unsupported fork: " + _network.asString() + " in " + _test.testName());
+    }
+    else
+        fork.params = prepareChainParams(_network, SealEngine::NoReward, _test.Pre(), _test.Env(), ParamsContext::StateTests);
+    fork.timestamp = spVALUE(_test.Env().firstBlockTimestamp().copy());
+    return fork;
+}
 
-    bool forkNotAllowed = false;
+// Execute the post results of one fork, return true if the fork is not allowed by the client config
+bool RunTestFork(StateTestFork const& _fork, StateTestPostResults const& _results, std::vector<TransactionInGeneralSection>& _txs)
+{
+    SessionInterface& session = RPCSession::instance(TestOutputHelper::getThreadID());
 
-    for (auto const& post : _test.Post())
-    {
-        bool networkSkip = false;
-        FORK const& network = post.first;
-        Options const& opt = Options::get();
+    // Without per transaction state inspection the transactions of a fork are executed in one batch
+    Options const& opt = Options::get();
+    bool const batchExecution = !opt.vmtrace && !opt.poststate && opt.logVerbosity < 5;
 
-        // If options singlenet select different network or test has network that is not allowed by clinet configs
-        if (!opt.singleTestNet.empty() && FORK(opt.singleTestNet) != network)
-            networkSkip = true;
-        else if (!Options::getDynamicOptions().getCurrentConfig().checkForkAllowed(network))
-        {
-            networkSkip = true;
-            forkNotAllowed = true;
-            ETH_WARNING("Skipping unsupported fork: " + network.asString() + " in " + _test.testName());
-        }
-        else
-        {
-            auto p = prepareChainParams(network, SealEngine::NoReward, _test.Pre(), _test.Env(), ParamsContext::StateTests);
-            session.test_setChainParams(p);
-        }
+    FORK const& network = _fork.network;
+    bool const networkSkip = _fork.networkSkip;
+    bool const forkNotAllowed = _fork.forkNotAllowed;
+    if (!networkSkip)
+        session.test_setChainParams(_fork.params);
 
-        // One test could have many transactions on same chainParams
-        // It is expected that for a setted chainParams there going to be a transaction
-        // Rather then all transactions would be filtered out and not executed at all
+    // One test could have many transactions on same chainParams
+    // It is expected that for a setted chainParams there going to be a transaction
+    // Rather then all transactions would be filtered out and not executed at all
 
-        // read all results for a specific fork
-        for (StateTestPostResult const& result : post.second)
+    // read all results for a specific fork
+    std::vector<StateTestJob> jobs;
+    for (StateTestPostResult const& result : _results)
+    {
+        bool resultHaveCorrespondingTransaction = false;
+        // look for a transaction with this indexes and execute it on a client
+        for (TransactionInGeneralSection& tr : _txs)
         {
-            bool resultHaveCorrespondingTransaction = false;
-            // look for a transaction with this indexes and execute it on a client
-            for (TransactionInGeneralSection& tr : txs)
-            {
-                if (ExitHandler::receivedExitSignal())
-                    return;
-
-                TestInfo errorInfo(network.asString(), tr.dataInd(), tr.gasInd(), tr.valueInd());
-                errorInfo.setTrDataDebug(tr.transaction()->dataLabel() + " " + tr.transaction()->dataRawPreview() + "..");
+            if (ExitHandler::receivedExitSignal())
+                return forkNotAllowed;
 
-                TestOutputHelper::get().setCurrentTestInfo(errorInfo);
-                bool checkIndexes = result.checkIndexes(tr.dataInd(), tr.gasInd(), tr.valueInd());
-                if (checkIndexes)
-                    resultHaveCorrespondingTransaction = true;
+            setStateTestInfo(network, tr);
+            bool checkIndexes = result.checkIndexes(tr.dataInd(), tr.gasInd(), tr.valueInd());
+            if (checkIndexes)
+                resultHaveCorrespondingTransaction = true;
 
-                if (!OptionsAllowTransaction(tr) || networkSkip)
-                {
-                    tr.markSkipped();
-                    continue;
-                }
+            if (!OptionsAllowTransaction(tr) || networkSkip)
+            {
+                tr.markSkipped();
+                continue;
+            }
 
-                if (checkIndexes)
+            if (checkIndexes)
+            {
+                if (batchExecution)
+                    jobs.push_back({&result, &tr});
+                else
                 {
-                    session.test_modifyTimestamp(_test.Env().firstBlockTimestamp());
+                    session.test_modifyTimestamp(_fork.timestamp);
                     FH32 trHash(session.eth_sendRawTransaction(tr.transaction()->getRawBytes(), tr.transaction()->getSecret()));
 
                     MineBlocksResult const mRes = session.test_mineBlocks(1);
-                    string const& testException = result.expectException();
-                    compareTransactionException(tr.transaction(), mRes, testException);
-
                     VALUE latestBlockN(session.eth_blockNumber());
                     EthGetBlockBy blockInfo(session.eth_getBlockByNumber(latestBlockN, Request::LESSOBJECTS));
-                    if (!blockInfo.hasTransaction(trHash) && testException.empty())
-                        ETH_ERROR_MESSAGE("StateTest::RunTest: " + c_trHashNotFound);
-                    tr.markExecuted();
+                    FH32 const logHash = Options::getDynamicOptions().getCurrentConfig().cfgFile().checkLogsHash() ?
+                                             FH32(session.test_getLogHash(trHash)) :
+                                             FH32::zero();
+                    checkStateTestResult(session, result, tr, MineTransactionResult(mRes, blockInfo, logHash));
+                    session.test_rewindToBlock(0);
+                }
+            }
+        } //ForTransactions
 
-                    // Validate post state
-                    FH32 const& expectedPostHash = result.hash();
-                    if (Options::get().vmtrace && !Options::get().filltests)
-                        printVmTrace(session, trHash, blockInfo.header()->stateRoot());
+        ETH_ERROR_REQUIRE_MESSAGE(resultHaveCorrespondingTransaction,
+            "Test `post` section has expect section without corresponding transaction!" + result.asDataObject()->asJson());
+    }
 
-                    FH32 const& actualHash = blockInfo.header()->stateRoot();
-                    if (actualHash != expectedPostHash)
-                    {
-                        if (Options::get().logVerbosity >= 5)
-                            ETH_LOG("\nState Dump: \n" + getRemoteState(session).asDataObject()->asJson(), 5);
-                        ETH_ERROR_MESSAGE("Post hash mismatch remote: " + actualHash.asString() +
-                                          ", expected: " + expectedPostHash.asString());
-                    }
-                    if (Options::get().poststate)
-                        ETH_LOG("\nRunning test State Dump:" + TestOutputHelper::get().testInfo().errorDebug() + cDefault + " \n" + getRemoteState(session).asDataObject()->asJson(), 1);
+    if (jobs.size())
+    {
+        TestOutputHelper::get().setCurrentTestInfo(
+            TestInfo("Batch of " + fto_string(jobs.size()) + " transactions on " + network.asString()));
+        std::vector<spTransaction> jobTxs;
+        for (auto const& job : jobs)
+            jobTxs.push_back(job.tr->transaction());
+        std::vector<MineTransactionResult> const results =
+            session.test_mineTransactionsBatch(jobTxs, _fork.timestamp);
+        ETH_ERROR_REQUIRE_MESSAGE(results.size() == jobs.size(), "test_mineTransactionsBatch returned wrong number of results!");
+        for (size_t i = 0; i < results.size() && i < jobs.size(); i++)
+        {
+            setStateTestInfo(network, *jobs.at(i).tr);
+            checkStateTestResult(session, *jobs.at(i).result, *jobs.at(i).tr, results.at(i));
+        }
+    }
+    return forkNotAllowed;
+}
 
-                    // Validate that txbytes field has the transaction data described in test `transaction` field.
-                    spBYTES const& expectedBytesPtr = result.bytesPtr();
-                    if (!expectedBytesPtr.isEmpty())
-                    {
-                        if (tr.transaction()->getRawBytes().asString() != expectedBytesPtr->asString())
-                            ETH_ERROR_MESSAGE("TxBytes mismatch: test transaction section doest not match txbytes in post section!");
-                    }
+/// Read and execute the test file
+void RunTest(StateTestInFilled const& _test)
+{
+    if (ExitHandler::receivedExitSignal())
+        return;
 
-                    // Validate log hash
-                    if (Options::getDynamicOptions().getCurrentConfig().cfgFile().checkLogsHash())
-                    {
-                        FH32 const& expectedLogHash = result.logs();
-                        FH32 remoteLogHash(session.test_getLogHash(trHash));
-                        if (remoteLogHash != expectedLogHash)
-                            ETH_ERROR_MESSAGE("Logs hash mismatch: '" + remoteLogHash.asString() + "', expected: '" +
-                                              expectedLogHash.asString() + "'");
-                    }
+    TestOutputHelper::get().setCurrentTestName(_test.testName());
+    std::vector<TransactionInGeneralSection> txs = buildRunTransactions(_test);
 
-                    session.test_rewindToBlock(0);
-                    if (Options::get().logVerbosity >= 5)
-                        ETH_LOG("Executed: d: " + to_string(tr.dataInd()) + ", g: " + to_string(tr.gasInd()) +
-                                    ", v: " + to_string(tr.valueInd()) + ", fork: " + network.asString(), 5);
-                }
-            } //ForTransactions
+    bool forkNotAllowed = false;
+    for (auto const& post : _test.Post())
+        forkNotAllowed = RunTestFork(prepareRunFork(_test, post.first), post.second, txs) || forkNotAllowed;
 
-            ETH_ERROR_REQUIRE_MESSAGE(resultHaveCorrespondingTransaction,
-                "Test `post` section has expect section without corresponding transaction!" + result.asDataObject()->asJson());
-        }
+    if (!forkNotAllowed)
+        checkUnexecutedTransactions(txs);
+}
+
+// Run the forks of the test as independent units on idle threads
+// Units share the parsed test, every unit gets its own transactions and chain params
+void RunTestByForks(StateTestInFilled const& _test)
+{
+    if (ExitHandler::receivedExitSignal())
+        return;
+
+    TestOutputHelper::get().setCurrentTestName(_test.testName());
+    std::vector<StateTestFork> preparedForks;
+    std::vector<std::vector<TransactionInGeneralSection>> unitTxs;
+    for (auto const& post : _test.Post())
+    {
+        preparedForks.push_back(prepareRunFork(_test, post.first));
+        unitTxs.push_back(buildRunTransactions(_test));
     }
 
+    std::vector<std::function<void()>> units;
+    for (size_t i = 0; i < preparedForks.size(); i++)
+    {
+        units.push_back([&_test, &preparedForks, &unitTxs, i]() {
+            StateTestFork const& fork = preparedForks.at(i);
+            RunTestFork(fork, _test.Post().at(fork.network), unitTxs.at(i));
+        });
+    }
+    ThreadManager::runUnits(units);
+
+    std::vector<TransactionInGeneralSection> txs = buildRunTransactions(_test);
+    mergeUnitTransactions(txs, unitTxs);
+    bool forkNotAllowed = false;
+    for (auto const& fork : preparedForks)
+        forkNotAllowed = forkNotAllowed || fork.forkNotAllowed;
+
     if (!forkNotAllowed)
         checkUnexecutedTransactions(txs);
 }
@@ -506,10 +700,12 @@ spDataObject StateTestSuite::doTests(spDataObject& _input, TestSuiteOptions& _op
         GeneralStateTestFiller filler(_input);
         StateTestInFiller const& test = filler.tests().at(0);
         checkTestNameIsEqualToFileName(test.testName());
+        dev::Timer testTimer;
         if (Options::get().fillchain)
             filledTest = FillTestAsBlockchain(test);
         else
             (*filledTest).addSubObject(test.testName(), FillTest(test));
+        ExecTimeStats::recordTestTime(TestOutputHelper::get().testFile(), test.testName(), testTimer.elapsed());
 
         TestOutputHelper::get().registerTestRunSuccess();
         return filledTest;
@@ -533,15 +729,23 @@ spDataObject StateTestSuite::doTests(spDataObject& _input, TestSuiteOptions& _op
                 _infoRef.renameKey("filledwith", "filling-rpc-server");
                 _infoRef["filling-tool-version"] = "testeth";
             }
+
             GeneralStateTest filledTest(_input);
 
             // Just check the test structure if running with --checkhash
             if (Options::get().checkhash)
                 return spDataObject();
 
+            Options const& opt = Options::get();
+            bool const splitByForks = !opt.vmtrace && !opt.poststate && ThreadManager::canSplitTasks();
             for (auto const& test : filledTest.tests())
             {
-                RunTest(test);
+                dev::Timer testTimer;
+                if (splitByForks && test.Post().size() > 1)
+                    RunTestByForks(test);
+                else
+                    RunTest(test);
+                ExecTimeStats::recordTestTime(TestOutputHelper::get().testFile(), test.testName(), testTimer.elapsed());
                 TestOutputHelper::get().registerTestRunSuccess();
             }
         }
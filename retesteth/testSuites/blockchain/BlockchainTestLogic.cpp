@@ -1,8 +1,10 @@
 #include "BlockchainTestLogic.h"
 #include <retesteth/EthChecks.h>
+#include <retesteth/ExecTimeStats.h>
 #include <retesteth/ExitHandler.h>
 #include <retesteth/Options.h>
 #include <retesteth/session/Session.h>
+#include <retesteth/session/ThreadManager.h>
 #include <retesteth/testStructures/Common.h>
 #include <retesteth/testStructures/PrepareChainParams.h>
 #include <retesteth/testSuites/Common.h>
@@ -239,7 +241,9 @@ spDataObject DoTests(spDataObject& _input, TestSuite::TestSuiteOptions& _opt)
             }
 
             // One blockchain test generate many tests for each network
+            dev::Timer testTimer;
             spDataObject filledTests = FillTest(bcTest, _opt);
+            ExecTimeStats::recordTestTime(TestOutputHelper::get().testFile(), bcTest.testName(), testTimer.elapsed());
             for (auto const& t : (*filledTests).getSubObjects())
                 (*tests).addSubObject(t);
             TestOutputHelper::get().registerTestRunSuccess();
@@ -271,6 +275,11 @@ spDataObject DoTests(spDataObject& _input, TestSuite::TestSuiteOptions& _opt)
             return tests;
         ETH_LOG("Parse test done", 5);
 
+        // Tests of the file could run on idle threads, every unit reads only its own test
+        Options const& opt = Options::get();
+        bool const splitTests =
+            !opt.vmtrace && !opt.poststate && test.tests().size() > 1 && ThreadManager::canSplitTasks();
+        std::vector<std::function<void()>> units;
         for (BlockchainTestInFilled const& bcTest : test.tests())
         {
             // Select test by name if --singletest and --singlenet is set
@@ -285,9 +294,24 @@ spDataObject DoTests(spDataObject& _input, TestSuite::TestSuiteOptions& _opt)
                 if (bcTest.network().asString() != Options::get().singleTestNet)
                     continue;
             }
+
+            if (splitTests)
+            {
+                units.push_back([&bcTest, &_opt]() {
+                    dev::Timer testTimer;
+                    RunTest(bcTest, _opt);
+                    ExecTimeStats::recordTestTime(TestOutputHelper::get().testFile(), bcTest.testName(), testTimer.elapsed());
+                    TestOutputHelper::get().registerTestRunSuccess();
+                });
+                continue;
+            }
+            dev::Timer testTimer;
             RunTest(bcTest, _opt);
+            ExecTimeStats::recordTestTime(TestOutputHelper::get().testFile(), bcTest.testName(), testTimer.elapsed());
             TestOutputHelper::get().registerTestRunSuccess();
         }
+        if (units.size())
+            ThreadManager::runUnits(units);
     }
     return tests;
 }
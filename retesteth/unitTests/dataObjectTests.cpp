@@ -18,11 +18,19 @@
  * Unit tests for TestHelper functions.
  */
 
+#include <dataObject/ConvertBinary.h>
 #include <dataObject/ConvertFile.h>
 #include <dataObject/DataObject.h>
+#include <dataObject/JsonWriter.h>
+#include <libdevcore/CommonIO.h>
+#include <retesteth/Options.h>
+#include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/testSuites/Common.h>
 #include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace dev;
@@ -829,6 +837,59 @@ BOOST_AUTO_TEST_CASE(dataobject_replace)
     BOOST_CHECK(data->asJson(0,false) == "{\"key2\":\"value2\"}");
 }
 
+BOOST_AUTO_TEST_CASE(dataobject_renamedInPlaceKeepsKey)
+{
+    // Children renamed in place are still found by the key they were added with
+    for (size_t size : {2, 100})
+    {
+        spDataObject obj;
+        for (size_t i = 0; i < size; i++)
+            (*obj)["key" + fto_string(i)] = fto_string(i);
+
+        DataObject value("y", "replaced");
+        (*obj)["key1"].replace(value);
+        BOOST_CHECK(obj->count("key1"));
+        BOOST_CHECK(!obj->count("y"));
+        BOOST_CHECK(obj->atKey("key1").asString() == "replaced");
+        BOOST_CHECK(obj->atKey("key1").getKey() == "y");
+
+        (*obj)["key0"].setKey("renamed");
+        BOOST_CHECK(obj->atKey("key0").getKey() == "renamed");
+        BOOST_CHECK((*obj)["key0"].asString() == "0");
+        BOOST_CHECK(obj->getSubObjects().size() == size);
+
+        // renameKey of the parent changes the lookup key
+        (*obj).renameKey("key1", "z");
+        BOOST_CHECK(!obj->count("key1"));
+        BOOST_CHECK(obj->atKey("z").asString() == "replaced");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_sharedLookupThreads)
+{
+    // Const lookups of a shared object rebuild its dirty index once
+    spDataObject obj;
+    for (size_t i = 0; i < 100; i++)
+        (*obj)["key" + fto_string(i)] = fto_string(i);
+    (*obj).getSubObjectsUnsafe().push_back(spDataObject(new DataObject("added", "value")));
+
+    DataObject const& shared = obj.getCContent();
+    std::vector<std::thread> workers;
+    std::vector<size_t> found(4, 0);
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        workers.emplace_back([&shared, &found, i]() {
+            for (size_t j = 0; j < 100; j++)
+                if (shared.count("added") && shared.atKey("key" + fto_string(j)).asString() == fto_string(j))
+                    found.at(i)++;
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    for (size_t const count : found)
+        BOOST_CHECK(count == 100);
+}
+
 BOOST_AUTO_TEST_CASE(dataobject_arrayhell)
 {
     string const data = R"(
@@ -881,4 +942,279 @@ BOOST_AUTO_TEST_CASE(dataobject_besuresponse)
     BOOST_CHECK(dObj->asJson(0, false) == expectedParse);
 }
 
+BOOST_AUTO_TEST_CASE(dataobject_readJsonStructuralsInStrings)
+{
+    // Strings and keys with structural characters and escaped quotes
+    string const padding(50, ' ');
+    string const value = R"(a\"{[:,]}b)";
+    string data = "{" + padding + "\"a\" : \"" + value + "\", \"b\\\"}\" : [" + padding + "\"" + value + value + "\"";
+    data += ", -7, true, null], \"c\" : {}, \"d\" : []}";
+    spDataObject dObj = ConvertJsoncppStringToData(data);
+    BOOST_CHECK(dObj->atKey("a").asString() == value);
+    BOOST_CHECK(dObj->atKey("b\\\"}").at(0).asString() == value + value);
+    BOOST_CHECK(dObj->atKey("b\\\"}").at(1).asInt() == -7);
+    BOOST_CHECK(dObj->asJson(0, false).find(",true,null],\"c\":{},\"d\":[]}") != string::npos);
+
+    for (char const* invalid : {"{\"a\" : \"b\\\"}", "{\"a\" : 1 2}", "[1, 2] {}"})
+        BOOST_CHECK_THROW(ConvertJsoncppStringToData(invalid), DataObjectException);
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_parseBenchmark)
+{
+    string json = "{\"test\" : {\"blocks\" : [";
+    for (size_t i = 0; i < 5000; i++)
+    {
+        json += i ? "," : "";
+        json += "{\"blockHeader\" : {\"number\" : \"" + fto_string(i) + "\", \"hash\" : \"0x" + string(64, 'a') +
+                "\", \"nonce\" : 1}, \"rlp\" : \"0x" + string(1000, 'f') + "\", \"transactions\" : []}";
+    }
+    json += "]}}";
+
+    auto const start = std::chrono::steady_clock::now();
+    spDataObject const document = ConvertJsoncppStringToData(json);
+    auto const time =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    ETH_LOG("Parsed " + fto_string(json.size() / 1000) + " KB at " + fto_string(json.size() / std::max<long>(time, 1)) +
+                " MB/s",
+        1);
+    BOOST_CHECK(document->atKey("test").atKey("blocks").getSubObjects().size() == 5000);
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_bigObjectKeys)
+{
+    // Big objects are looked up with the hash index
+    spDataObject obj;
+    for (size_t i = 0; i < 100; i++)
+        (*obj)["key" + fto_string(i)] = fto_string(i);
+    BOOST_CHECK(obj->getSubObjects().size() == 100);
+    BOOST_CHECK(obj->atKey("key57").asString() == "57");
+    BOOST_CHECK(!obj->count("key100"));
+
+    (*obj).removeKey("key10");
+    BOOST_CHECK(!obj->count("key10"));
+    BOOST_CHECK(obj->atKey("key11").asString() == "11");
+    BOOST_CHECK(obj->at(10).getKey() == "key11");
+
+    (*obj).renameKey("key20", "renamed");
+    BOOST_CHECK(!obj->count("key20"));
+    BOOST_CHECK(obj->atKey("renamed").asString() == "20");
+
+    // Children added through the unsafe accessor are found by the next lookup, const too
+    spDataObject added(new DataObject("added", "value"));
+    (*obj).getSubObjectsUnsafe().push_back(added);
+    DataObject const& constObj = obj.getCContent();
+    BOOST_CHECK(constObj.count("added"));
+    BOOST_CHECK(constObj.atKey("added").asString() == "value");
+
+    spDataObject sorted;
+    (*sorted).setAutosort(true);
+    for (size_t i = 100; i > 0; i--)
+        (*sorted)["key" + fto_string(i + 100)] = fto_string(i);
+    BOOST_CHECK(sorted->at(0).getKey() == "key101");
+    BOOST_CHECK(sorted->atKey("key150").asString() == "50");
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_arena)
+{
+    // Blockchain test like document with many small nodes
+    string json = "{\"test\" : {\"blocks\" : [";
+    for (size_t i = 0; i < 2000; i++)
+    {
+        json += i ? "," : "";
+        json += "{\"blockHeader\" : {\"number\" : \"" + fto_string(i) + "\", \"gasLimit\" : \"0x7fffffff\"," +
+                "\"extraData\" : \"0x42\", \"nonce\" : \"0x0000000000000000\"}, \"transactions\" : []}";
+    }
+    json += "]}}";
+
+    spDataObject document(0);
+    size_t nodes = 0;
+    size_t slabs = 0;
+    {
+        DataObjectArenaScope arena;
+        document = ConvertJsoncppStringToData(json);
+        nodes = arena.nodes();
+        slabs = arena.slabs();
+    }
+    BOOST_CHECK(nodes >= 2000 * 7);
+    BOOST_CHECK(slabs * 100 < nodes);
+
+    // The document outlives the scope, nodes created after the scope use the heap
+    BOOST_CHECK(!DataObjectArenaScope::isOpen());
+    spDataObject const block = document->atKey("test").atKey("blocks").at(1999).atKey("blockHeader").copy();
+    document = spDataObject(0);
+    BOOST_CHECK(block->atKey("number").asString() == "1999");
+
+    // Heap and arena nodes in one document, the arena nodes are released on another thread
+    {
+        DataObjectArenaScope arena;
+        document = ConvertJsoncppStringToData(json);
+    }
+    (*document)["test"]["blocks"].addArrayObject(block);
+    std::thread([&document]() { document = spDataObject(0); }).join();
+    BOOST_CHECK(block->atKey("number").asString() == "1999");
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_binaryRoundTrip)
+{
+    string const json = R"({"b" : {"z" : -2147483647, "a" : [true, null, "0x\\\"", {}]}, "a" : 2147483647, "" : []})";
+    for (bool autosort : {false, true})
+    {
+        spDataObject const dObj = ConvertJsoncppStringToData(json, string(), autosort);
+        string const binary = ConvertDataToBinary(dObj.getCContent());
+        spDataObject const restored = ConvertBinaryToData(binary.data(), binary.size());
+        BOOST_CHECK(restored->asJson() == dObj->asJson());
+        BOOST_CHECK(restored->atKey("b").isAutosort() == autosort);
+        BOOST_CHECK(restored->atKey("b").atKey("z").asInt() == -2147483647);
+
+        // Truncated data is rejected
+        for (size_t i = 0; i < binary.size(); i++)
+            BOOST_CHECK_THROW(ConvertBinaryToData(binary.data(), i), DataObjectException);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_writeJsonSinks)
+{
+    spDataObject const dObj = ConvertJsoncppStringToData(R"({"b" : {"z" : 1, "a" : [{"y" : 1, "x" : 2}]}, "a" : true})");
+    string compact;
+    StringSink sink(compact);
+    dObj->writeJson(sink, 0, false);
+    BOOST_CHECK(compact == dObj->asJson(0, false));
+
+    std::ostringstream stream;
+    StreamSink streamSink(stream);
+    dObj->writeJson(streamSink);
+    BOOST_CHECK(stream.str() == dObj->asJson());
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_writeJsonSortKeys)
+{
+    spDataObject const dObj = ConvertJsoncppStringToData(
+        R"({"b" : {"z" : 1, "a" : [{"y" : 1, "x" : 2}], "B" : null}, "ab" : "v", "a" : true})");
+    string sorted;
+    StringSink sink(sorted);
+    dObj->writeJson(sink, 0, false, false, true);
+    BOOST_CHECK(sorted == R"({"a":true,"ab":"v","b":{"B":null,"a":[{"x":2,"y":1}],"z":1}})");
+
+    // The object keeps its order, array elements are not reordered
+    BOOST_CHECK(dObj->asJson(0, false) == R"({"b":{"z":1,"a":[{"y":1,"x":2}],"B":null},"ab":"v","a":true})");
+
+    // Same order as the recursive mod_sortKeys
+    spDataObject copy;
+    (*copy).copyFrom(dObj.getCContent());
+    (*copy).performModifier(mod_sortKeys);
+    BOOST_CHECK(sorted == copy->asJson(0, false));
+
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    writeJsonFile((tmpDir / "sorted.json").string(), dObj, true, true);
+    BOOST_CHECK(dev::contentsString(tmpDir / "sorted.json") == copy->asJson());
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_CASE(dataobject_writeJsonFile)
+{
+    spDataObject document;
+    for (size_t i = 0; i < 100; i++)
+    {
+        spDataObject block;
+        (*block)["blockHeader"]["number"] = fto_string(i);
+        (*block)["rlp"] = "0x" + string(1000, 'f');
+        (*document)["test"]["blocks"].addArrayObject(block);
+    }
+
+    // The file is written in several buffers and readable by the owner only
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    writeJsonFile((tmpDir / "stream.json").string(), document);
+    BOOST_CHECK(dev::contentsString(tmpDir / "stream.json") == document->asJson());
+    BOOST_CHECK(fs::status(tmpDir / "stream.json").permissions() == (fs::owner_read | fs::owner_write));
+    BOOST_CHECK_THROW(writeJsonFile((tmpDir / "missing" / "stream.json").string(), document), DataObjectException);
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_CASE(spointer_move)
+{
+    spDataObject obj(new DataObject("value"));
+    spDataObject copy = obj;
+    BOOST_CHECK(obj.getRefCount() == 2);
+
+    // Moved pointer takes the reference without touching the counter
+    spDataObject moved(std::move(copy));
+    BOOST_CHECK(obj.getRefCount() == 2);
+    BOOST_CHECK(copy.isEmpty());
+
+    spDataObject other(new DataObject("other"));
+    other = std::move(moved);
+    BOOST_CHECK(obj.getRefCount() == 2);
+    BOOST_CHECK(moved.isEmpty());
+    BOOST_CHECK(other->asString() == "value");
+
+    // Move of the same pointee drops one reference
+    spDataObject same = obj;
+    other = std::move(same);
+    BOOST_CHECK(obj.getRefCount() == 2);
+    other = spDataObject(0);
+    BOOST_CHECK(obj.getRefCount() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(spointer_refcountThreads)
+{
+    // Copies of one pointer on several threads must leave the counter consistent
+    spDataObject const shared(new DataObject("value"));
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < 4; i++)
+    {
+        workers.emplace_back([&shared]() {
+            for (size_t j = 0; j < 10000; j++)
+            {
+                spDataObject copy = shared;
+                (void)copy;
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    BOOST_CHECK(shared.getRefCount() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(spointer_refcountBenchmark)
+{
+    // Pointer copies on 1, 2, 4 .. threads, up to -j or the number of cores. Each thread copies
+    // its own pointer, then all threads copy one shared pointer. The counters of different
+    // objects do not share a lock, so the time of the first case should stay flat as threads grow
+    size_t const c_copies = 200000;
+    size_t const maxThreads = std::max<size_t>(Options::get().threadCount, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        for (bool sharedPointer : {false, true})
+        {
+            spDataObject const shared(new DataObject("value"));
+            std::vector<spDataObject> own;
+            for (size_t i = 0; i < threads; i++)
+                own.push_back(sharedPointer ? shared : spDataObject(new DataObject("value")));
+
+            auto const start = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (size_t i = 0; i < threads; i++)
+            {
+                spDataObject const& pointer = sharedPointer ? shared : own.at(i);
+                workers.emplace_back([&pointer]() {
+                    for (size_t j = 0; j < c_copies; j++)
+                    {
+                        spDataObject copy = pointer;
+                        (void)copy;
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            auto const time =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            ETH_LOG(string(sharedPointer ? "Shared" : "Own") + " SPointer copies on " + fto_string(threads) +
+                        " threads: " + fto_string(time) + " us",
+                1);
+            own.clear();
+            BOOST_CHECK(shared.getRefCount() == 1);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
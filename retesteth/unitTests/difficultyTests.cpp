@@ -0,0 +1,98 @@
+#include <retesteth/TestOutputHelper.h>
+#include <retesteth/session/ToolBackend/ToolChainHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace test;
+using namespace toolimpl;
+
+namespace
+{
+ChainOperationParams forkParams(string const& _fork, string const& _londonForkBlock = string())
+{
+    DataObject data;
+    data["fork"] = _fork;
+    if (!_londonForkBlock.empty())
+        data["londonForkBlock"] = _londonForkBlock;
+    return ChainOperationParams::defaultParams(ToolParams(data));
+}
+
+bigint difficulty(string const& _fork, bigint const& _number, bigint const& _timestampDiff,
+    bigint const& _parentDifficulty, bool _parentHasUncles = false)
+{
+    DifficultyArgs args;
+    args.number = _number;
+    args.parentTimestamp = 1000;
+    args.timestamp = 1000 + _timestampDiff;
+    args.parentDifficulty = _parentDifficulty;
+    args.parentHasUncles = _parentHasUncles;
+    return calculateEthashDifficulty(forkParams(_fork), args);
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(DifficultySuite, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(difficulty_forkParams)
+{
+    DataObject berlin;
+    berlin["fork"] = "Berlin";
+    ToolParams const berlinParams(berlin);
+    BOOST_CHECK(berlinParams.knownFork());
+    BOOST_CHECK(berlinParams.muirGlacierForkBlock() == 0);
+    BOOST_CHECK(berlinParams.londonForkBlock() != 0);
+
+    DataObject transition;
+    transition["fork"] = "BerlinToLondonAt5";
+    transition["londonForkBlock"] = "0x05";
+    ToolParams const transitionParams(transition);
+    BOOST_CHECK(transitionParams.muirGlacierForkBlock() == 0);
+    BOOST_CHECK(transitionParams.londonForkBlock() == 5);
+
+    DataObject unknown;
+    unknown["fork"] = "UnknownFork";
+    BOOST_CHECK(!ToolParams(unknown).knownFork());
+}
+
+BOOST_AUTO_TEST_CASE(difficulty_frontier)
+{
+    BOOST_CHECK(difficulty("Frontier", 1, 0, 131072) == 131136);
+    BOOST_CHECK(difficulty("Frontier", 1, 13, 1000000) == 999512);
+}
+
+BOOST_AUTO_TEST_CASE(difficulty_homesteadNegativeTimestamp)
+{
+    // -5 / 10 is rounded to -1
+    BOOST_CHECK(difficulty("Homestead", 1, -5, 131072) == 131200);
+}
+
+BOOST_AUTO_TEST_CASE(difficulty_minimumBeforeBomb)
+{
+    // Target is below the minimum difficulty, the bomb is added on top of the minimum
+    BOOST_CHECK(difficulty("Byzantium", 5000000, 100, 131072) == 131072 + 262144);
+}
+
+BOOST_AUTO_TEST_CASE(difficulty_bombDelays)
+{
+    BOOST_CHECK(difficulty("London", 10800000, 1, 131072, true) == 131200 + 512);
+    BOOST_CHECK(difficulty("ArrowGlacier", 10800000, 1, 131072, true) == 131200);
+    BOOST_CHECK(difficulty("Berlin", 9250000, 1, 131072) == 131136 + 1);
+    BOOST_CHECK(difficulty("Istanbul", 9250000, 1, 131072) == 131136 + (bigint(1) << 40));
+}
+
+BOOST_AUTO_TEST_CASE(difficulty_gridThreads)
+{
+    std::vector<DifficultyArgs> args;
+    for (size_t i = 1; i <= 2048; i++)
+        args.push_back({i * 10000, 1000 + i % 30, 1000, 131072 + i, i % 2 == 0});
+
+    ChainOperationParams const params = forkParams("Byzantium");
+    std::vector<VALUE> const single = calculateEthashDifficultyGrid(params, args, 1);
+    std::vector<VALUE> const threaded = calculateEthashDifficultyGrid(params, args, 4);
+    BOOST_REQUIRE(single.size() == args.size());
+    BOOST_REQUIRE(threaded.size() == args.size());
+    for (size_t i = 0; i < args.size(); i++)
+        BOOST_CHECK(single.at(i) == threaded.at(i));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -557,6 +557,9 @@ BOOST_AUTO_TEST_CASE(clientconfigTest)
     // Check address Order
     BOOST_CHECK(cfg.socketAdresses().at(0).asString() == "127.0.0.1:8545");
     BOOST_CHECK(cfg.socketAdresses().at(1).asString() == "127.0.0.1:8546");
+
+    // Default tool communication mode
+    BOOST_CHECK(cfg.toolMode() == test::teststruct::ClientConfgToolMode::Files);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
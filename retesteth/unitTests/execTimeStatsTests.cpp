@@ -0,0 +1,71 @@
+#include <retesteth/ExecTimeStats.h>
+#include <retesteth/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace test;
+
+BOOST_FIXTURE_TEST_SUITE(ExecTimeStatsSuite, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(execTimeStats_update)
+{
+    ExecTimeRecords records;
+    double time = 0;
+    BOOST_CHECK(!records.expected("cfg run a.json", time));
+
+    // First record is taken as is, the next ones are averaged with it
+    records.update("cfg run a.json", 4);
+    BOOST_CHECK(records.expected("cfg run a.json", time));
+    BOOST_CHECK(time == 4);
+    records.update("cfg run a.json", 2);
+    records.expected("cfg run a.json", time);
+    BOOST_CHECK(time == 3);
+}
+
+BOOST_AUTO_TEST_CASE(execTimeStats_fileTimeFromTests)
+{
+    ExecTimeRecords records;
+    records.update(ExecTimeRecords::testKey("cfg run a.json", "test1"), 1);
+    records.update(ExecTimeRecords::testKey("cfg run a.json", "test2"), 2);
+    records.update(ExecTimeRecords::testKey("cfg run a.jsonx", "test1"), 10);
+
+    double time = 0;
+    BOOST_CHECK(records.expectedFileTime("cfg run a.json", time));
+    BOOST_CHECK(time == 3);
+
+    // The file record is preferred over its tests
+    records.update("cfg run a.json", 5);
+    records.expectedFileTime("cfg run a.json", time);
+    BOOST_CHECK(time == 5);
+    BOOST_CHECK(!records.expectedFileTime("cfg run b.json", time));
+}
+
+BOOST_AUTO_TEST_CASE(execTimeStats_longestFirst)
+{
+    ExecTimeRecords records;
+    records.update("a", 1);
+    records.update("b", 5);
+    records.update("d", 1);
+    records.update(ExecTimeRecords::testKey("e", "test"), 3);
+
+    // Unknown files first, equal times keep the order
+    std::vector<size_t> const order = records.longestFirst({"a", "b", "c", "d", "e"});
+    std::vector<size_t> const expected = {2, 1, 4, 0, 3};
+    BOOST_CHECK(order == expected);
+}
+
+BOOST_AUTO_TEST_CASE(execTimeStats_serialize)
+{
+    ExecTimeRecords records;
+    records.update("cfg run a b.json", 1.5);
+    records.update(ExecTimeRecords::testKey("cfg run a b.json", "test"), 0.25);
+
+    ExecTimeRecords parsed;
+    std::vector<string> malformed;
+    parsed.parse(records.serialize() + "abc cfg run c.json\n", malformed);
+    BOOST_CHECK(parsed.serialize() == records.serialize());
+    BOOST_REQUIRE(malformed.size() == 1);
+    BOOST_CHECK(malformed.at(0) == "abc cfg run c.json");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
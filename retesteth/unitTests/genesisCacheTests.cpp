@@ -0,0 +1,54 @@
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/TestOutputHelper.h>
+#include <retesteth/session/ToolBackend/GenesisCache.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace test;
+using namespace toolimpl;
+
+BOOST_FIXTURE_TEST_SUITE(GenesisCacheSuite, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(genesisCache_hitAndMiss)
+{
+    FH32 const key("0x" + toString(sha3(string("genesisCache_hitAndMiss"))));
+    FH32 const root("0x" + toString(sha3(string("root"))));
+    BOOST_CHECK(findGenesisStateRoot(key).isEmpty());
+
+    cacheGenesisStateRoot(key, root);
+    spFH32 const found = findGenesisStateRoot(key);
+    BOOST_REQUIRE(!found.isEmpty());
+    BOOST_CHECK(found.getCContent() == root);
+
+    // The first record of the key is kept
+    cacheGenesisStateRoot(key, FH32::zero());
+    BOOST_CHECK(findGenesisStateRoot(key).getCContent() == root);
+
+    FH32 const otherKey("0x" + toString(sha3(string("genesisCache_hitAndMiss other"))));
+    BOOST_CHECK(findGenesisStateRoot(otherKey).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(genesisCache_toolIdentity)
+{
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    fs::path const tool = tmpDir / "tool.sh";
+    writeFileExec(tool, bytesConstRef(string("#!/bin/sh\necho evm version 1\n")));
+
+    string const identity = toolIdentity(tool);
+    BOOST_CHECK(identity.find("evm version 1") != string::npos);
+    BOOST_CHECK(toolIdentity(tool) == identity);
+
+    // Upgraded tool has another identity, so the genesis cache keys change
+    writeFileExec(tool, bytesConstRef(string("#!/bin/sh\necho evm version 1.1\n")));
+    string const upgraded = toolIdentity(tool);
+    BOOST_CHECK(upgraded != identity);
+    BOOST_CHECK(upgraded.find("evm version 1.1") != string::npos);
+
+    BOOST_CHECK(toolIdentity(tmpDir / "missing.sh") == (tmpDir / "missing.sh").string());
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
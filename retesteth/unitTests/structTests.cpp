@@ -1,7 +1,10 @@
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
+#include <retesteth/session/ToolBackend/TransactionValidation.h>
 #include <retesteth/testStructures/basetypes.h>
 #include <retesteth/testStructures/types/Ethereum/TransactionReader.h>
+#include <retesteth/testStructures/types/RPC/DebugVMTrace.h>
+#include <retesteth/testStructures/types/RPC/TestRawTranasction.h>
 #include <boost/test/unit_test.hpp>
 #include <functional>
 
@@ -393,4 +396,64 @@ BOOST_AUTO_TEST_CASE(transactionLegacy_vbigint_serialization)
     ETH_ERROR_REQUIRE_MESSAGE(spTr->hash() == spTr2->hash(), "Transaction deserialized hash is different (before != after) " + spTr->hash().asString() + " != " + spTr2->hash().asString())
 }
 
+BOOST_AUTO_TEST_CASE(transactionLegacy_nativeValidation)
+{
+    // Signed creation transaction from transactionLegacy_serialization
+    BYTES const rlp(DataObject("0xf850010a83112233801184001122331ca020705a98ccbb2eff7872ba4df9854597732e6a4436252ff7acc56ce7"
+                               "aeebe17aa01869c076e616f3aeeaa160ab6050a1c009a58eda3ab6752ddb87dc6762e03112"));
+    FH20 const sender("0xa94f5374fce5edbaf8f3a12e4b4fef8ca8d2cd67");
+
+    // creation + 1 zero byte + 3 non zero bytes of data
+    std::vector<std::pair<string, int>> const intrinsicGas = {
+        {"Frontier", 21000 + 4 + 3 * 68}, {"Homestead", 53000 + 4 + 3 * 68}, {"Istanbul", 53000 + 4 + 3 * 16}};
+    for (auto const& el : intrinsicGas)
+    {
+        spDataObject const res = toolimpl::validateTransaction(rlp, FORK(el.first));
+        BOOST_REQUIRE(!res.isEmpty());
+        TestRawTransaction const tr(res.getCContent());
+        ETH_ERROR_REQUIRE_MESSAGE(tr.error().empty(), el.first + " transaction rejected: " + tr.error());
+        ETH_ERROR_REQUIRE_MESSAGE(tr.sender() == sender, el.first + " sender is different: " + tr.sender().asString());
+        ETH_ERROR_REQUIRE_MESSAGE(tr.intrinsicGas() == el.second, el.first + " intrinsicGas is different: " + tr.intrinsicGas().asDecString());
+    }
+
+    // Non canonical and unknown fork are left for the tool
+    BOOST_CHECK(toolimpl::validateTransaction(BYTES(DataObject(rlp.asString() + "00")), FORK("Berlin")).isEmpty());
+    BOOST_CHECK(toolimpl::validateTransaction(rlp, FORK("UnknownFork")).isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(transactionLegacy_nativeValidationBadSignature)
+{
+    // s is above secp256k1n / 2 which is forbidden since Homestead
+    BYTES const rlp(DataObject("0xf850010a83112233801184001122331ba020705a98ccbb2eff7872ba4df9854597732e6a4436252ff7acc56ce7"
+                               "aeebe17aa0e796c3f89e90c51155f9f549fa5e3ff0eba6ee8b7a06330ce1f2c13a9c7b4ed0"));
+    spDataObject const res = toolimpl::validateTransaction(rlp, FORK("Berlin"));
+    BOOST_REQUIRE(!res.isEmpty());
+    TestRawTransaction const tr(res.getCContent());
+    BOOST_CHECK(!tr.error().empty());
+    BOOST_CHECK(tr.sender() == FH20::zero());
+}
+
+BOOST_AUTO_TEST_CASE(debugVMTrace_lazyRecords)
+{
+    string const logs =
+        "{\"pc\":0,\"op\":96,\"gas\":\"0x5c878\",\"gasCost\":\"0x3\",\"memory\":\"0x\",\"memSize\":0,\"stack\":[],"
+        "\"returnData\":\"0x\",\"depth\":1,\"refund\":0,\"opName\":\"PUSH1\",\"error\":\"\"}\n"
+        "{\"pc\":2,\"op\":85,\"gas\":\"0x5c875\",\"gasCost\":\"0x4e20\",\"memory\":\"0x\",\"memSize\":0,"
+        "\"stack\":[\"0x1\",\"0x0\"],\"returnData\":\"0x\",\"depth\":2,\"refund\":0,\"opName\":\"SSTORE\",\"error\":\"\"}\r\n"
+        "{\"output\":\"\",\"gasUsed\":\"0x4e23\",\"time\":1234}\n";
+
+    DebugVMTrace const trace("", "0", FH32::zero(), logs);
+    VMTraceLog const& log = trace.log();
+    BOOST_REQUIRE(log.size() == 2);
+    BOOST_CHECK(log.pc(1) == 2);
+    BOOST_CHECK(log.op(1) == 85);
+    BOOST_CHECK(log.gas(0) == 0x5c878);
+    BOOST_CHECK(log.depth(1) == 2);
+
+    VMLogRecord const record = log.record(1);
+    BOOST_CHECK(record.opName == "SSTORE");
+    BOOST_CHECK(record.stack.size() == 2);
+    BOOST_CHECK(log.summaryLine() == "{\"output\":\"\",\"gasUsed\":\"0x4e23\",\"time\":1234}");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -19,9 +19,12 @@
  */
 
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <retesteth/dataObject/ConvertFile.h>
 #include <retesteth/TestHelper.h>
 #include <retesteth/TestOutputHelper.h>
 #include <retesteth/configs/ClientConfig.h>
+#include <retesteth/session/Socket.h>
 #include <boost/test/unit_test.hpp>
 #include <retesteth/Options.h>
 
@@ -253,4 +256,44 @@ BOOST_AUTO_TEST_CASE(getTestSuggestions2)
     BOOST_CHECK(test::inArray(list, string("BCGeneralStateTests/stExample")));
 }
 
+BOOST_AUTO_TEST_CASE(jsonObjectValidator_framing)
+{
+    // Braces inside of the strings are not counted, the response is split between the chunks
+    string const response = "{\"result\":\"a}]\\\"{\",\"id\":[1,{}]}";
+    string const stream = "\n" + response + "\n{\"id\":2}";
+    JsonObjectValidator validator;
+    size_t used = 0;
+    for (size_t i = 0; i < stream.size() && !validator.completeResponse(); i += 3)
+        used += validator.acceptResponse(stream.data() + i, std::min<size_t>(3, stream.size() - i));
+    BOOST_CHECK(validator.completeResponse());
+    BOOST_CHECK(used == response.size() + 1);
+    BOOST_CHECK(validator.takeResponse() == response);
+}
+
+BOOST_AUTO_TEST_CASE(readJsonData_mappedFile)
+{
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    fs::path const file = tmpDir / "test.json";
+    writeFile(file, dev::asBytes(R"({"test" : {"_info" : {"comment" : "mapped"}, "blocks" : [1, "0x01", {}]}})"));
+
+    spDataObject const data = test::readJsonData(file);
+    BOOST_CHECK(data->atKey("test").atKey("_info").atKey("comment").asString() == "mapped");
+    BOOST_CHECK(data->asJson(0, false) == R"({"test":{"_info":{"comment":"mapped"},"blocks":[1,"0x01",{}]}})");
+
+    spDataObject const info = test::readJsonData(file, "_info");
+    BOOST_CHECK(info->asJson(0, false) == R"({"test":{"_info":{"comment":"mapped"}}})");
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_CASE(sha3Json_compactPrintHash)
+{
+    spDataObject data = ConvertJsoncppStringToData(R"({"b" : {"a" : [1, -2, true, null, {}, []]}, "c" : "0x\\\""})");
+    (*data)["d"] = "new\nline\ttab";
+    BOOST_CHECK(test::sha3Json(data) == dev::sha3(data->asJson(0, false)));
+
+    // Longer than the sha3 block
+    (*data)["e"] = string(1000, 'f');
+    BOOST_CHECK(test::sha3Json(data) == dev::sha3(data->asJson(0, false)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
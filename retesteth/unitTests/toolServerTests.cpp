@@ -0,0 +1,84 @@
+#include <libdevcore/CommonIO.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/TestOutputHelper.h>
+#include <retesteth/dataObject/ConvertFile.h>
+#include <retesteth/session/ToolBackend/ToolServer.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace dev;
+using namespace test;
+using namespace toolimpl;
+
+namespace
+{
+// Tool server that returns the request payload as the result
+string const c_echoTool = R"(#!/bin/bash
+export LC_ALL=C
+while read -r size; do
+    payload=$(head -c "$size")
+    response="{\"result\":$payload,\"alloc\":{}}"
+    printf '%s\n%s' "${#response}" "$response"
+done
+)";
+
+// Tool server that exits on the first request
+string const c_brokenTool = R"(#!/bin/bash
+read -r size
+exit 0
+)";
+
+fs::path makeTool(fs::path const& _dir, string const& _script)
+{
+    fs::path const tool = _dir / "tool.sh";
+    writeFileExec(tool, bytesConstRef(_script));
+    return tool;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(ToolServerSuite, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(toolServer_requestT8n)
+{
+    if (!test::checkCmdExist("bash"))
+        return;
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    ToolServer server(makeTool(tmpDir, c_echoTool), tmpDir);
+    BOOST_CHECK(server.isRunning());
+
+    // Arguments with quotes and backslashes are escaped in the request
+    spDataObject const alloc = ConvertJsoncppStringToData(R"({"0x01" : {"balance" : "0x01"}})");
+    spDataObject const env = ConvertJsoncppStringToData(R"({"currentNumber" : "0x01"})");
+    string const args = " --state.fork \"Berlin\" --output.basedir C:\\tmp";
+    spDataObject const res = server.requestT8n(args, alloc, env, "[]");
+
+    DataObject const& request = res->atKey("result");
+    BOOST_CHECK(request.atKey("method").asString() == "t8n");
+    BOOST_CHECK(request.atKey("args").asString() == " --state.fork \\\"Berlin\\\" --output.basedir C:\\\\tmp");
+    BOOST_CHECK(request.atKey("alloc").atKey("0x01").atKey("balance").asString() == "0x01");
+    BOOST_CHECK(request.atKey("env").atKey("currentNumber").asString() == "0x01");
+    BOOST_CHECK(request.atKey("txs").type() == DataType::Array);
+
+    // The request objects are not changed
+    BOOST_CHECK(alloc->getKey().empty() && env->getKey().empty());
+
+    server.stop();
+    BOOST_CHECK(!server.isRunning());
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_CASE(toolServer_brokenTool)
+{
+    if (!test::checkCmdExist("bash"))
+        return;
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    ToolServer server(makeTool(tmpDir, c_brokenTool), tmpDir);
+
+    // Tool exits without the response, the write or the read fails without SIGPIPE
+    BOOST_CHECK_THROW(server.request(string(1024 * 1024, ' ')), UpwardsException);
+    BOOST_CHECK(!server.isRunning());
+    BOOST_CHECK_THROW(server.request("{}"), UpwardsException);
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/SHA3.h>
+#include <libdevcore/TrieHash.h>
+#include <retesteth/TestHelper.h>
+#include <retesteth/TestOutputHelper.h>
+#include <retesteth/dataObject/ConvertFile.h>
+#include <retesteth/session/ToolBackend/ToolChainHelper.h>
+#include <retesteth/testStructures/types/ethereum.h>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+
+using namespace std;
+using namespace dev;
+using namespace test;
+using namespace test::teststruct;
+using namespace toolimpl;
+
+namespace
+{
+spDataObject makeAccount(string const& _balance, string const& _nonce, string const& _code)
+{
+    spDataObject acc;
+    (*acc)["balance"] = _balance;
+    (*acc)["nonce"] = _nonce;
+    (*acc)["code"] = _code;
+    (*acc).atKeyPointer("storage") = spDataObject(new DataObject(DataType::Object));
+    return acc;
+}
+
+spDataObject makeBenchmarkAlloc(size_t _accounts)
+{
+    spDataObject alloc;
+    for (size_t i = 1; i <= _accounts; i++)
+    {
+        spDataObject acc = makeAccount(toCompactHexPrefixed(u256(i * 1000000), 1), "0x01", "0x6001600101");
+        (*acc)["storage"]["0x01"] = toCompactHexPrefixed(u256(i), 1);
+        (*acc)["storage"]["0x02"] = "0x02";
+        (*alloc).atKeyPointer(toHexPrefixed(h160(u160(i)))) = acc;
+    }
+    return alloc;
+}
+}  // namespace
+
+BOOST_FIXTURE_TEST_SUITE(TrieSuite, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(trie_emptyRoot)
+{
+    BOOST_CHECK(toHex(hash256(BytesMap())) == "56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421");
+    BOOST_CHECK(toHex(orderedTrieRoot({})) == "56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421");
+}
+
+BOOST_AUTO_TEST_CASE(trie_anyorder)
+{
+    BytesMap dogs{{dev::asBytes("doe"), dev::asBytes("reindeer")}, {dev::asBytes("dog"), dev::asBytes("puppy")},
+        {dev::asBytes("dogglesworth"), dev::asBytes("cat")}};
+    BOOST_CHECK(toHex(hash256(dogs)) == "8aad789dff2f538bca5d8ea56e8abe10f4c7ba3a5dea95fea4cd6e7c3a1168d3");
+
+    BytesMap puppy{{dev::asBytes("do"), dev::asBytes("verb")}, {dev::asBytes("horse"), dev::asBytes("stallion")},
+        {dev::asBytes("doge"), dev::asBytes("coin")}, {dev::asBytes("dog"), dev::asBytes("puppy")}};
+    BOOST_CHECK(toHex(hash256(puppy)) == "5991bb8c6514148a29db676a14ac506cd2cd5775ace63c30a4fe457715e9ac84");
+
+    BytesMap foo{{dev::asBytes("foo"), dev::asBytes("bar")}, {dev::asBytes("food"), dev::asBytes("bass")}};
+    BOOST_CHECK(toHex(hash256(foo)) == "17beaa1648bafa633cda809c90c04af50fc8aed3cb40d16efbddee6fdf63c4c3");
+
+    BytesMap smallValues{{dev::asBytes("be"), dev::asBytes("e")}, {dev::asBytes("dog"), dev::asBytes("puppy")},
+        {dev::asBytes("bed"), dev::asBytes("d")}};
+    BOOST_CHECK(toHex(hash256(smallValues)) == "3f67c7a47520f79faa29255d2d3c084a7a6df0453116ed7232ff10277a8be68b");
+}
+
+BOOST_AUTO_TEST_CASE(trie_stateRootSingleAccount)
+{
+    string const address = "0xa94f5374fce5edbaf8f3a12e4b4fef8ca8d2cd67";
+    spDataObject alloc;
+    (*alloc).atKeyPointer(address) = makeAccount("0x0de0b6b3a7640000", "0x00", "0x");
+    State state(dataobject::move(alloc));
+
+    // Single leaf trie: sha3(rlp([hexPrefix(sha3(address)), rlp(account)]))
+    RLPStream account(4);
+    account << u256(0) << u256("0x0de0b6b3a7640000") << EmptyTrie << EmptySHA3;
+    bytes leafKey(1, 0x20);
+    bytes const hashedAddress = sha3(fromHex(address)).asBytes();
+    leafKey.insert(leafKey.end(), hashedAddress.begin(), hashedAddress.end());
+    RLPStream leaf(2);
+    leaf << leafKey << account.out();
+
+    FH32 const expected("0x" + toString(sha3(leaf.out())));
+    BOOST_CHECK(calculateStateRoot(state) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(trie_stateRootZeroStorage)
+{
+    string const address = "0x095e7baea6a6c7c4c2dfeb977efac326af552d87";
+    spDataObject allocA;
+    (*allocA).atKeyPointer(address) = makeAccount("0x01", "0x01", "0x600160010160005500");
+    spDataObject allocB;
+    (*allocB).atKeyPointer(address) = makeAccount("0x01", "0x01", "0x600160010160005500");
+    (*allocB)[address]["storage"]["0x01"] = "0x00";
+
+    // Zero storage values are not stored in the trie
+    State stateA(dataobject::move(allocA));
+    State stateB(dataobject::move(allocB));
+    BOOST_CHECK(calculateStateRoot(stateA) == calculateStateRoot(stateB));
+}
+
+BOOST_AUTO_TEST_CASE(trie_stateRootAccountsWithStorage)
+{
+    // Expected roots are calculated with an independent keccak/rlp/trie implementation
+    spDataObject alloc;
+    (*alloc).atKeyPointer("0xa94f5374fce5edbaf8f3a12e4b4fef8ca8d2cd67") = makeAccount("0x0de0b6b3a7640000", "0x00", "0x");
+    (*alloc).atKeyPointer("0x095e7baea6a6c7c4c2dfeb977efac326af552d87") =
+        makeAccount("0x0de0b6b3a7640000", "0x01", "0x600160010160005500");
+    (*alloc)["0x095e7baea6a6c7c4c2dfeb977efac326af552d87"]["storage"]["0x00"] = "0x01";
+    (*alloc)["0x095e7baea6a6c7c4c2dfeb977efac326af552d87"]["storage"]["0x01"] = "0x0102";
+    (*alloc).atKeyPointer("0x2adc25665018aa1fe0e6bc666dac8fc2697ff9ba") = makeAccount("0x00", "0x00", "0x");
+    (*alloc).atKeyPointer("0x1000000000000000000000000000000000000000") = makeAccount("0x00", "0x00", "0x60003560005500");
+    (*alloc)["0x1000000000000000000000000000000000000000"]["storage"]["0x01"] =
+        "0xffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff";
+    (*alloc)["0x1000000000000000000000000000000000000000"]["storage"]["0xff"] = "0x02";
+    State state(dataobject::move(alloc));
+    BOOST_CHECK(calculateStateRoot(state) == FH32("0x4c25d666ca0ef1e2e23a25eac64f18a79a22624bfc5a7aae5e897d297792900f"));
+
+    spDataObject bigAlloc = makeBenchmarkAlloc(1000);
+    State bigState(dataobject::move(bigAlloc));
+    BOOST_CHECK(calculateStateRoot(bigState) == FH32("0x959177e312edb1abd5232ccbdef110a59045c76da9a78c7fd187977a4bb169ab"));
+}
+
+BOOST_AUTO_TEST_CASE(trie_emptyLists)
+{
+    BOOST_CHECK(calculateTransactionRoot({}) ==
+                FH32("0x56e81f171bcc55a6ff8345e692c0f86e5b48e01b996cadc001622fb5e363b421"));
+    BOOST_CHECK(calculateUncleHash({}) == FH32("0x1dcc4de8dec75d7aab85b567b6ccd41ad312451b948a7413f0a142fd40d49347"));
+}
+
+BOOST_AUTO_TEST_CASE(trie_stateRootBenchmark)
+{
+    // Native stateRoot against the `evm t8n` round trip it replaces. Times are logged, the tool
+    // part runs only when geth evm is installed
+    size_t const c_accounts = 1000;
+    spDataObject alloc = makeBenchmarkAlloc(c_accounts);
+    string const allocJson = alloc->asJson();
+    State state(dataobject::move(alloc));
+
+    auto start = std::chrono::steady_clock::now();
+    FH32 const nativeRoot = calculateStateRoot(state);
+    auto const nativeTime =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    ETH_LOG("Native stateRoot of " + fto_string(c_accounts) + " accounts: " + fto_string(nativeTime) + " us", 1);
+
+    if (!test::checkCmdExist("evm"))
+        return;
+
+    fs::path const tmpDir = test::createUniqueTmpDirectory();
+    writeFile(tmpDir / "alloc.json", dev::asBytes(allocJson));
+    writeFile(tmpDir / "txs.json", dev::asBytes("[]"));
+    writeFile(tmpDir / "env.json", dev::asBytes(R"({
+        "currentCoinbase" : "0x2adc25665018aa1fe0e6bc666dac8fc2697ff9ba",
+        "currentDifficulty" : "0x020000",
+        "currentGasLimit" : "0x05f5e100",
+        "currentNumber" : "0x01",
+        "currentTimestamp" : "0x03e8"
+    })"));
+
+    string cmd = "evm t8n --state.fork Berlin --state.reward -1";
+    cmd += " --input.alloc " + (tmpDir / "alloc.json").string();
+    cmd += " --input.txs " + (tmpDir / "txs.json").string();
+    cmd += " --input.env " + (tmpDir / "env.json").string();
+    cmd += " --output.basedir " + tmpDir.string() + " --output.result out.json --output.alloc outAlloc.json";
+
+    start = std::chrono::steady_clock::now();
+    test::executeCmd(cmd, ExecCMDWarning::NoWarning);
+    string const out = contentsString(tmpDir / "out.json");
+    auto const toolTime =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    ETH_LOG("Tool stateRoot of " + fto_string(c_accounts) + " accounts: " + fto_string(toolTime) + " us", 1);
+
+    spDataObject const res = dataobject::ConvertJsoncppStringToData(out);
+    BOOST_CHECK(FH32(res->atKey("stateRoot").asString()) == nativeRoot);
+    fs::remove_all(tmpDir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()